@@ -0,0 +1,153 @@
+// Compares the linear (y -> z -> x) chunk layout used by chunk::localIndex with a Z-order (Morton)
+// layout, for the two ways the terrain is read: every cell looking at its six neighbours, as face
+// culling does, and rays stepping through cells, as findCursorBlock does. Build with
+// -DASS3_BENCHMARKS=ON and run bin/layout_bench
+
+#include <ass3/chunk.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+    const int WORLD_CHUNKS = 6;
+    const int WORLD_SIZE = WORLD_CHUNKS * chunk::CHUNK_SIZE;
+    const int TOTAL_RAYS = 200000;
+    const int RAY_STEPS = 64;
+    const int REPEATS = 5;
+
+    // Spreads the low 4 bits of value out to every third bit
+    inline int spreadBits(int value) {
+        value = (value | (value << 4)) & 0x0C3;
+        value = (value | (value << 2)) & 0x249;
+        return value;
+    }
+
+    inline int linearIndex(int x, int y, int z) {
+        return chunk::localIndex(x, y, z);
+    }
+
+    inline int mortonIndex(int x, int y, int z) {
+        return spreadBits(x) | (spreadBits(z) << 1) | (spreadBits(y) << 2);
+    }
+
+    // A cube of chunks, each one a separate allocation like the terrain's
+    template <int (*INDEX)(int, int, int)>
+    struct world_t {
+        std::vector<std::vector<uint8_t>> chunks;
+
+        world_t() : chunks((size_t)(WORLD_CHUNKS * WORLD_CHUNKS * WORLD_CHUNKS), std::vector<uint8_t>(chunk::CHUNK_VOLUME, chunk::AIR)) {}
+
+        uint8_t get(int x, int y, int z) const {
+            if ((unsigned)x >= (unsigned)WORLD_SIZE || (unsigned)y >= (unsigned)WORLD_SIZE || (unsigned)z >= (unsigned)WORLD_SIZE) return chunk::AIR;
+            const int size = chunk::CHUNK_SIZE;
+            const auto &section = chunks[(size_t)(((y / size) * WORLD_CHUNKS + z / size) * WORLD_CHUNKS + x / size)];
+            return section[(size_t)INDEX(x % size, y % size, z % size)];
+        }
+
+        void set(int x, int y, int z, uint8_t id) {
+            const int size = chunk::CHUNK_SIZE;
+            chunks[(size_t)(((y / size) * WORLD_CHUNKS + z / size) * WORLD_CHUNKS + x / size)][(size_t)INDEX(x % size, y % size, z % size)] = id;
+        }
+    };
+
+    struct ray_t {
+        float x, y, z, dx, dy, dz;
+    };
+
+    // Rolling hills of stone with caves cut out of them
+    template <typename W>
+    void generate(W &world) {
+        std::mt19937 random(3421);
+        for (int y = 0; y < WORLD_SIZE; y++) {
+            for (int z = 0; z < WORLD_SIZE; z++) {
+                for (int x = 0; x < WORLD_SIZE; x++) {
+                    auto ground = WORLD_SIZE / 2 + (int)(8.0f * std::sin((float)x * 0.1f) * std::cos((float)z * 0.1f));
+                    if (y < ground && random() % 10 != 0) world.set(x, y, z, (uint8_t)(1 + random() % 4));
+                }
+            }
+        }
+    }
+
+    template <typename W>
+    long cullFaces(const W &world) {
+        long visible = 0;
+        // Chunk by chunk in the same y -> z -> x order as the mesher
+        for (int chunkIndex = 0; chunkIndex < WORLD_CHUNKS * WORLD_CHUNKS * WORLD_CHUNKS; chunkIndex++) {
+            auto origin = glm::ivec3(chunkIndex % WORLD_CHUNKS, chunkIndex / (WORLD_CHUNKS * WORLD_CHUNKS), (chunkIndex / WORLD_CHUNKS) % WORLD_CHUNKS) * chunk::CHUNK_SIZE;
+            for (int y = origin.y; y < origin.y + chunk::CHUNK_SIZE; y++) {
+                for (int z = origin.z; z < origin.z + chunk::CHUNK_SIZE; z++) {
+                    for (int x = origin.x; x < origin.x + chunk::CHUNK_SIZE; x++) {
+                        if (world.get(x, y, z) == chunk::AIR) continue;
+                        visible += (world.get(x, y - 1, z) == chunk::AIR) + (world.get(x, y + 1, z) == chunk::AIR) +
+                            (world.get(x, y, z + 1) == chunk::AIR) + (world.get(x, y, z - 1) == chunk::AIR) +
+                            (world.get(x + 1, y, z) == chunk::AIR) + (world.get(x - 1, y, z) == chunk::AIR);
+                    }
+                }
+            }
+        }
+        return visible;
+    }
+
+    template <typename W>
+    long castRays(const W &world, const std::vector<ray_t> &rays) {
+        long hits = 0;
+        for (const auto &ray : rays) {
+            auto x = ray.x, y = ray.y, z = ray.z;
+            for (int step = 0; step < RAY_STEPS; step++) {
+                x += ray.dx;
+                y += ray.dy;
+                z += ray.dz;
+                if (world.get((int)x, (int)y, (int)z) != chunk::AIR) {
+                    hits++;
+                    break;
+                }
+            }
+        }
+        return hits;
+    }
+
+    template <typename F>
+    double bestOf(F func, long &result) {
+        double best = 1e30;
+        for (int i = 0; i < REPEATS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            result = func();
+            std::chrono::duration<double, std::milli> taken = std::chrono::steady_clock::now() - start;
+            best = std::min(best, taken.count());
+        }
+        return best;
+    }
+}
+
+int main() {
+    world_t<linearIndex> linear;
+    world_t<mortonIndex> morton;
+    generate(linear);
+    generate(morton);
+
+    std::mt19937 random(21);
+    std::uniform_real_distribution<float> position(0.0f, (float)WORLD_SIZE), direction(-1.0f, 1.0f);
+    std::vector<ray_t> rays((size_t)TOTAL_RAYS);
+    for (auto &ray : rays) {
+        ray = {position(random), position(random), position(random), direction(random), direction(random), direction(random)};
+        auto length = std::sqrt(ray.dx * ray.dx + ray.dy * ray.dy + ray.dz * ray.dz) * 2.0f;
+        ray.dx /= length;
+        ray.dy /= length;
+        ray.dz /= length;
+    }
+
+    long linearResult = 0, mortonResult = 0;
+    auto linearCull = bestOf([&]() { return cullFaces(linear); }, linearResult);
+    auto mortonCull = bestOf([&]() { return cullFaces(morton); }, mortonResult);
+    std::printf("Face culling: linear %.2fms, morton %.2fms (%ld faces%s)\n", linearCull, mortonCull, linearResult, linearResult == mortonResult ? "" : ", MISMATCH");
+
+    auto linearRays = bestOf([&]() { return castRays(linear, rays); }, linearResult);
+    auto mortonRays = bestOf([&]() { return castRays(morton, rays); }, mortonResult);
+    std::printf("Raycasts:     linear %.2fms, morton %.2fms (%ld hits%s)\n", linearRays, mortonRays, linearResult, linearResult == mortonResult ? "" : ", MISMATCH");
+    return 0;
+}
@@ -0,0 +1,74 @@
+#ifndef COMP3421_ASS3_BLOCKS_HPP
+#define COMP3421_ASS3_BLOCKS_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace blocks {
+
+    // Which kind of particles a block spawns around itself
+    enum emitter_t : uint8_t {
+        NO_EMITTER = 0,
+        SMOKE_EMITTER,  // magma
+        TEAR_EMITTER,   // crying obsidian
+        DUST_EMITTER,   // redstone ore
+        GLINT_EMITTER,  // marccoin block
+        FISH_EMITTER,   // coral
+    };
+
+    // Everything the hot paths need to know about a block type. Kept small so the
+    // whole table stays in cache
+    struct properties_t {
+        glm::vec3 rgb = glm::vec3(0.0f);
+        float intensity = 1.0f;
+        emitter_t emitter = NO_EMITTER;
+        bool transparent = false;
+        bool illuminating = false;
+        bool rotatable = false;
+        bool mirror = false;
+        bool bouncy = false;
+    };
+
+    // Dense table of block types. A block type ID is an index into properties and
+    // names, ID 0 is always air
+    struct registry_t {
+        std::vector<properties_t> properties;
+        std::vector<std::string> names;
+
+        /**
+         * @brief Empties the registry, leaving only air
+         * 
+         */
+        void clear();
+
+        /**
+         * @brief Registers a new block type and returns its ID. Returns 0 (air) if the registry is full
+         * 
+         * @param name 
+         * @param transparent 
+         * @param illuminating 
+         * @param rotatable 
+         * @param rgb 
+         * @param intensity 
+         * @return uint8_t 
+         */
+        uint8_t add(const std::string &name, bool transparent, bool illuminating, bool rotatable, glm::vec3 rgb, float intensity);
+
+        /**
+         * @brief Finds the ID of the block with the given name. Returns 0 (air) if it does not exist
+         * 
+         * @param name 
+         * @return uint8_t 
+         */
+        uint8_t find(const std::string &name) const;
+
+        const properties_t &operator[](uint8_t id) const {
+            return properties[id];
+        }
+    };
+}
+
+#endif //COMP3421_ASS3_BLOCKS_HPP
@@ -0,0 +1,626 @@
+#ifndef COMP3421_ASS3_CHUNK_HPP
+#define COMP3421_ASS3_CHUNK_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace chunk {
+
+    const int CHUNK_SIZE = 16;
+    const int CHUNK_AREA = CHUNK_SIZE * CHUNK_SIZE;
+    const int CHUNK_VOLUME = CHUNK_AREA * CHUNK_SIZE;
+
+    // Block type ID reserved for empty cells
+    const uint8_t AIR = 0;
+
+    // Bit set in a face mask for each face of a cube, in the same order as shapes::createCubeTemplate
+    const uint8_t FACE_BOTTOM = 1 << 0;
+    const uint8_t FACE_TOP = 1 << 1;
+    const uint8_t FACE_FRONT = 1 << 2;
+    const uint8_t FACE_BACK = 1 << 3;
+    const uint8_t FACE_RIGHT = 1 << 4;
+    const uint8_t FACE_LEFT = 1 << 5;
+    const uint8_t ALL_FACES = 0x3F;
+
+    // How a block type hides the faces of the blocks next to it. Blocks with neither flag (air and
+    // mirrors) hide nothing
+    const uint8_t OPAQUE_FLAG = 1 << 0; // hides every face
+    const uint8_t GLASS_FLAG = 1 << 1;  // only hides the faces of other glass blocks
+
+    // Worlds where fewer than this fraction of chunks hold a block are kept sparse
+    const float SPARSE_OCCUPANCY = 0.25f;
+
+    // Tallest world the column heightmaps can describe
+    const int MAX_HEIGHT = 256;
+
+    // Data that only a handful of cells need. Stored in a side table so the
+    // common case (a plain block) costs a single byte
+    struct blockInstance_t {
+        glm::vec3 rotation = glm::vec3(0.0f);
+        int lightID = -1;
+        GLuint reflectionTexID = 0;
+    };
+
+    // One cell to set as part of a batch of edits
+    struct blockEdit_t {
+        int x = 0, y = 0, z = 0;
+        uint8_t id = AIR;
+    };
+
+    // Block type IDs of every cell in a chunk. Each cell stores an index into a list of the types
+    // the chunk holds, packed 1, 2 or 4 bits to a cell depending on how long that list is. Chunks of
+    // one type don't store any cells, and chunks with more than 16 types store the IDs themselves
+    // in 8 bits. The cell width grows as types are added and only shrinks on fill
+    struct palette_t {
+        // Block type IDs the cell indices point to. Unused when bits is 8
+        std::vector<uint8_t> types = {AIR};
+        std::vector<uint64_t> words;
+        // Bits per cell, 0 while every cell is types[0]
+        int bits = 0;
+
+        /**
+         * @brief Returns the block type ID of the given cell
+         * 
+         * @param index 
+         * @return uint8_t 
+         */
+        uint8_t get(int index) const {
+            if (bits == 0) return types[0];
+            // Cell widths divide 64, so a cell never spans two words
+            auto bit = (size_t)index * (size_t)bits;
+            auto value = (uint8_t)((words[bit >> 6] >> (bit & 63)) & ((1u << bits) - 1));
+            return bits == 8 ? value : types[value];
+        }
+
+        /**
+         * @brief Sets count cells starting from the given cell to the given block type ID
+         * 
+         * @param first 
+         * @param count 
+         * @param id 
+         */
+        void set(int first, int count, uint8_t id);
+
+        /**
+         * @brief Sets every cell to the given block type ID, freeing the packed cells
+         * 
+         * @param id 
+         */
+        void fill(uint8_t id);
+
+        /**
+         * @brief Approximate number of bytes allocated outside of the palette itself
+         * 
+         * @return size_t 
+         */
+        size_t memoryUsage() const {
+            return types.capacity() + words.capacity() * sizeof(uint64_t);
+        }
+    };
+
+    // One bit per cell along x for every (y, z) row of a chunk, so faces can be culled a whole row at a time
+    struct chunkRows_t {
+        std::array<uint16_t, CHUNK_AREA> solid{};
+        std::array<uint16_t, CHUNK_AREA> opaque{};
+        std::array<uint16_t, CHUNK_AREA> glass{};
+    };
+
+    // A 16x16x16 section of the world. Cells are laid out y -> z -> x so that the
+    // x axis is contiguous, matching the order the world is scanned in. This measured faster than
+    // Z-order for both neighbour lookups and raycasts, see bench/layout_bench.cpp
+    struct chunk_t {
+        palette_t blocks;
+        std::unordered_map<uint16_t, blockInstance_t> instances;
+        // Only allocated once a block is placed in the chunk, nullptr rows are all empty
+        std::unique_ptr<chunkRows_t> rows;
+        int totalSolid = 0;
+        // Cells holding a block that hides every face, the chunk can't be seen into when this is CHUNK_VOLUME
+        int totalOpaque = 0;
+        // Set whenever a block inside this chunk or on its border changes, so its mesh needs rebuilding
+        bool dirty = true;
+        // Set while the chunk is waiting in terrain_t::dirtyChunks
+        bool queued = false;
+        // Set once the player changes a block in the chunk, so it is kept when paged out
+        bool edited = false;
+    };
+
+    // Which cells of one (x, z) column of the world hold a block, one bit per y level, with the
+    // lowest and highest of them kept so most queries don't need to look at the bits. Each run of
+    // solid cells is a run of set bits, found with a bit scan
+    struct column_t {
+        std::array<uint64_t, MAX_HEIGHT / 64> solid{};
+        // -1 while the column is empty
+        int16_t lowest = -1, highest = -1;
+    };
+
+    // The columns of every chunk stacked at one chunk x and z, indexed z * CHUNK_SIZE + x
+    struct heightmap_t {
+        std::array<column_t, CHUNK_AREA> columns;
+    };
+
+    // What a ray cast through the terrain ran into. normal points out of the face that was hit, so
+    // block + normal is the empty cell the ray came through. It is zero if the ray started inside
+    // the block
+    struct raycast_t {
+        bool hit = false;
+        glm::ivec3 block = glm::ivec3(0);
+        glm::ivec3 normal = glm::ivec3(0);
+        float distance = 0.0f;
+    };
+
+    /**
+     * @brief Converts chunk local co-ordinates into an index into chunk_t::blocks
+     * 
+     * @param x 
+     * @param y 
+     * @param z 
+     * @return int 
+     */
+    inline int localIndex(int x, int y, int z) {
+        return (y * CHUNK_SIZE + z) * CHUNK_SIZE + x;
+    }
+
+    /**
+     * @brief Converts an index into chunk_t::blocks back into chunk local co-ordinates
+     * 
+     * @param index 
+     * @return glm::ivec3 
+     */
+    inline glm::ivec3 localPosition(int index) {
+        return glm::ivec3(index % CHUNK_SIZE, index / CHUNK_AREA, (index / CHUNK_SIZE) % CHUNK_SIZE);
+    }
+
+    // Chunked storage for every block in the world. Dense terrain allocates every chunk up front.
+    // Sparse terrain only stores the chunks that have held a block, so mostly empty worlds cost
+    // memory and scan time for what is in them rather than for their size
+    struct terrain_t {
+        int width = 0, height = 0;
+        int chunksX = 0, chunksY = 0, chunksZ = 0;
+        bool sparse = true;
+        // Set when chunks are paged in and out around the player. Every loaded chunk is stored,
+        // even empty ones, so a chunk that isn't stored hasn't been loaded and can't be edited
+        bool paged = false;
+        // Every chunk in chunkIndex order, only used by dense terrain
+        std::vector<chunk_t> chunks;
+        // Chunks which have held a block keyed by chunkIndex, only used by sparse terrain
+        std::unordered_map<size_t, chunk_t> sparseChunks;
+        // OPAQUE_FLAG and GLASS_FLAG of every block type ID
+        std::array<uint8_t, 256> blockFlags{};
+        // Index of every chunk made dirty since the list was last emptied, each listed once
+        std::vector<size_t> dirtyChunks;
+        // Heightmaps of every chunk column with a block in it, keyed by chunkZ * chunksX + chunkX
+        std::unordered_map<size_t, heightmap_t> heightmaps;
+
+        /**
+         * @brief Sets up an empty world of the given width and height, which is capped at
+         * MAX_HEIGHT. Every cell starts as air. The terrain starts sparse, see setSparse
+         * 
+         * @param worldWidth 
+         * @param worldHeight 
+         */
+        void init(int worldWidth, int worldHeight);
+
+        /**
+         * @brief Moves every chunk over to sparse or dense storage. Chunks without any blocks are
+         * dropped when going sparse
+         * 
+         * @param makeSparse 
+         */
+        void setSparse(bool makeSparse);
+
+        /**
+         * @brief Fraction of the world's chunks which hold at least one block
+         * 
+         * @return float 
+         */
+        float occupancy() const;
+
+        /**
+         * @brief Number of chunks currently stored
+         * 
+         * @return size_t 
+         */
+        size_t totalChunks() const {
+            return sparse ? sparseChunks.size() : chunks.size();
+        }
+
+        /**
+         * @brief Calls func(chunkIndex, chunk) on every stored chunk. Chunks which aren't stored
+         * are all air
+         * 
+         * @param func 
+         */
+        template <typename F>
+        void forEachChunk(F func) {
+            if (sparse) {
+                for (auto &entry : sparseChunks) func(entry.first, entry.second);
+            } else {
+                for (size_t index = 0; index < chunks.size(); index++) func(index, chunks[index]);
+            }
+        }
+
+        template <typename F>
+        void forEachChunk(F func) const {
+            if (sparse) {
+                for (const auto &entry : sparseChunks) func(entry.first, entry.second);
+            } else {
+                for (size_t index = 0; index < chunks.size(); index++) func(index, chunks[index]);
+            }
+        }
+
+        /**
+         * @brief Checks if the given x, y, z co-ordinates are outside of the world
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return true if out of bounds
+         * @return false if inside bounds
+         */
+        bool isOutOfBounds(int x, int y, int z) const {
+            // Negative co-ordinates wrap to huge unsigned values, so one compare covers both ends
+            return ((unsigned)x >= (unsigned)width) | ((unsigned)y >= (unsigned)height) | ((unsigned)z >= (unsigned)width);
+        }
+
+        /**
+         * @brief Returns the block type ID at the given co-ordinates. Co-ordinates must be within bounds
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return uint8_t 
+         */
+        uint8_t getBlock(int x, int y, int z) const {
+            return chunkAt(x, y, z).blocks.get(localIndex(x & (CHUNK_SIZE - 1), y & (CHUNK_SIZE - 1), z & (CHUNK_SIZE - 1)));
+        }
+
+        /**
+         * @brief Returns the block type ID at the given co-ordinates, or air if they are outside of
+         * the world. Safe to call with any co-ordinates, which makes it the accessor to use for
+         * neighbour lookups. Out of range co-ordinates are clamped onto the edge of the world and the
+         * answer is masked to air, so there is no branch on the bounds check
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return uint8_t 
+         */
+        uint8_t blockOrAir(int x, int y, int z) const {
+            auto inside = (uint8_t)!isOutOfBounds(x, y, z);
+            auto id = getBlock(std::clamp(x, 0, width - 1), std::clamp(y, 0, height - 1), std::clamp(z, 0, width - 1));
+            return (uint8_t)(id & (uint8_t)-inside);
+        }
+
+        /**
+         * @brief Returns true if the cell at the given co-ordinates is inside the world and is not air
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return true 
+         * @return false 
+         */
+        bool isSolid(int x, int y, int z) const {
+            return blockOrAir(x, y, z) != AIR;
+        }
+
+        /**
+         * @brief Sets the block type ID at the given co-ordinates. Any per-instance data is removed.
+         * Does nothing inside a chunk that hasn't been loaded
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @param id 
+         */
+        void setBlock(int x, int y, int z, uint8_t id);
+
+        /**
+         * @brief Sets every cell in the box between the two corners (inclusive) to the given block
+         * type ID, writing whole rows of each chunk at once. Parts of the box outside of the world
+         * and in chunks that haven't been loaded are ignored. Any per-instance data inside the box is removed
+         * 
+         * @param from minimum corner
+         * @param to maximum corner
+         * @param id 
+         */
+        void fillBox(glm::ivec3 from, glm::ivec3 to, uint8_t id);
+
+        /**
+         * @brief Works out the solid, opaque and glass rows of the given chunk and its number of
+         * solid and opaque cells from its blocks. Only writes the chunk itself, so it can run on any thread
+         * 
+         * @param section 
+         */
+        void rebuildRows(chunk_t &section) const;
+
+        /**
+         * @brief Sets every cell of the given chunk inside the box between the two corners
+         * (inclusive, in chunk local co-ordinates) to the given block type ID. Only the chunk itself
+         * is written, nothing is marked dirty and the heightmaps aren't updated, so different chunks
+         * can be filled on different threads. See refreshHeightmap
+         * 
+         * @param section 
+         * @param from 
+         * @param to 
+         * @param id 
+         */
+        void fillChunk(chunk_t &section, glm::ivec3 from, glm::ivec3 to, uint8_t id) const;
+
+        /**
+         * @brief Sets how the given block type hides its neighbours' faces. Must be set before any
+         * block of that type is placed
+         * 
+         * @param id 
+         * @param flags OPAQUE_FLAG, GLASS_FLAG or neither
+         */
+        void setBlockFlags(uint8_t id, uint8_t flags) {
+            blockFlags[id] = flags;
+        }
+
+        /**
+         * @brief Works out which faces of every cell in the given chunk can be seen. Bit i of a
+         * cell's mask is set if face i can be seen. A face is visible if the cell next to it is air,
+         * a mirror or outside the world. Glass faces are also hidden by other glass, every other
+         * block's faces show through glass. Only reads the terrain, so different chunks can be done
+         * on different threads
+         * 
+         * @param chunkX 
+         * @param chunkY 
+         * @param chunkZ 
+         * @param masks 
+         */
+        void findFaceMasks(int chunkX, int chunkY, int chunkZ, std::array<uint8_t, CHUNK_VOLUME> &masks) const;
+
+        /**
+         * @brief Checks if nothing inside the chunk at the given chunk co-ordinates can be seen,
+         * either because it is all air or because it is full of opaque blocks and every face on its
+         * outside is covered by an opaque neighbour. Such chunks can be skipped by meshing
+         * 
+         * @param chunkX 
+         * @param chunkY 
+         * @param chunkZ 
+         * @return true 
+         * @return false 
+         */
+        bool isHidden(int chunkX, int chunkY, int chunkZ) const;
+
+        /**
+         * @brief Returns the heightmap column at the given x and z co-ordinates, nullptr if it is
+         * outside of the world or has never held a block
+         * 
+         * @param x 
+         * @param z 
+         * @return const column_t* 
+         */
+        const column_t *findColumn(int x, int z) const {
+            if (((unsigned)x >= (unsigned)width) | ((unsigned)z >= (unsigned)width)) return nullptr;
+            auto found = heightmaps.find((size_t)(z / CHUNK_SIZE) * (size_t)chunksX + (size_t)(x / CHUNK_SIZE));
+            if (found == heightmaps.end()) return nullptr;
+            return &found->second.columns[(size_t)((z % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE)];
+        }
+
+        /**
+         * @brief Returns the highest y at or below the given y with a block in the column at the
+         * given x and z, -1 if there isn't one
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return int 
+         */
+        int solidBelow(int x, int y, int z) const;
+
+        /**
+         * @brief Returns the lowest y at or above the given y with a block in the column at the
+         * given x and z, -1 if there isn't one
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return int 
+         */
+        int solidAbove(int x, int y, int z) const;
+
+        /**
+         * @brief Finds the first solid block along a ray, visiting each cell the ray passes through
+         * exactly once in order (Amanatides and Woo's voxel traversal)
+         * 
+         * @param origin 
+         * @param direction doesn't need to be normalised
+         * @param maxDistance 
+         * @return raycast_t 
+         */
+        raycast_t raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance) const;
+
+        /**
+         * @brief Sets or clears the cells from fromY to toY (inclusive) in the heightmap column at
+         * the given x and z. Called by every edit so the heightmaps follow the blocks
+         * 
+         * @param x 
+         * @param z 
+         * @param fromY 
+         * @param toY 
+         * @param solid 
+         */
+        void setColumnCells(int x, int z, int fromY, int toY, bool solid);
+
+        /**
+         * @brief Rebuilds the part of the heightmap covered by the chunk at the given chunk
+         * co-ordinates from its blocks. Used for chunks filled with fillChunk, which leaves the
+         * heightmaps alone, and for chunks paged in or out
+         * 
+         * @param chunkX 
+         * @param chunkY 
+         * @param chunkZ 
+         */
+        void refreshHeightmap(int chunkX, int chunkY, int chunkZ);
+
+        /**
+         * @brief Returns the chunk at the given chunk co-ordinates, nullptr if it is outside of the
+         * world or is an empty chunk that isn't stored
+         * 
+         * @param chunkX 
+         * @param chunkY 
+         * @param chunkZ 
+         * @return chunk_t* 
+         */
+        chunk_t *findChunk(int chunkX, int chunkY, int chunkZ) {
+            return const_cast<chunk_t *>(static_cast<const terrain_t *>(this)->findChunk(chunkX, chunkY, chunkZ));
+        }
+
+        const chunk_t *findChunk(int chunkX, int chunkY, int chunkZ) const {
+            if (((unsigned)chunkX >= (unsigned)chunksX) | ((unsigned)chunkY >= (unsigned)chunksY) | ((unsigned)chunkZ >= (unsigned)chunksZ)) {
+                return nullptr;
+            }
+            auto index = chunkIndex(chunkX, chunkY, chunkZ);
+            if (!sparse) return &chunks[index];
+            auto found = sparseChunks.find(index);
+            return found == sparseChunks.end() ? nullptr : &found->second;
+        }
+
+        /**
+         * @brief Checks if every chunk in the column holding the given x and z co-ordinates is
+         * loaded. Always true unless the terrain is paged
+         * 
+         * @param x 
+         * @param z 
+         * @return true 
+         * @return false 
+         */
+        bool isColumnLoaded(int x, int z) const {
+            if (!paged) return true;
+            for (int chunkY = 0; chunkY < chunksY; chunkY++) {
+                if (!findChunk(x / CHUNK_SIZE, chunkY, z / CHUNK_SIZE)) return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Returns the per-instance data of the given cell, nullptr if it has none
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return blockInstance_t* 
+         */
+        blockInstance_t *findInstance(int x, int y, int z);
+
+        /**
+         * @brief Returns the per-instance data of the given cell, creating it if it has none
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return blockInstance_t& 
+         */
+        blockInstance_t &getInstance(int x, int y, int z);
+
+        /**
+         * @brief Removes any per-instance data of the given cell
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         */
+        void clearInstance(int x, int y, int z);
+
+        /**
+         * @brief Gets the chunk which holds the given co-ordinates, storing a new empty chunk first
+         * if the terrain is sparse and doesn't have one. Co-ordinates must be within bounds
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return chunk_t& 
+         */
+        chunk_t &chunkAt(int x, int y, int z) {
+            auto index = chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE);
+            return sparse ? sparseChunks[index] : chunks[index];
+        }
+
+        /**
+         * @brief Gets the chunk which holds the given co-ordinates. Chunks which aren't stored are
+         * read as a shared all air chunk. Co-ordinates must be within bounds
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return const chunk_t& 
+         */
+        const chunk_t &chunkAt(int x, int y, int z) const {
+            static const chunk_t empty;
+            auto section = findChunk(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE);
+            return section ? *section : empty;
+        }
+
+        /**
+         * @brief Converts chunk co-ordinates (world co-ordinates divided by CHUNK_SIZE) into an index
+         * into chunks, also used as the key of sparseChunks
+         * 
+         * @param chunkX 
+         * @param chunkY 
+         * @param chunkZ 
+         * @return size_t 
+         */
+        size_t chunkIndex(int chunkX, int chunkY, int chunkZ) const {
+            return (size_t)((chunkY * chunksZ + chunkZ) * chunksX + chunkX);
+        }
+
+        /**
+         * @brief Converts a chunk index back into chunk co-ordinates
+         * 
+         * @param index 
+         * @return glm::ivec3 
+         */
+        glm::ivec3 chunkPosition(size_t index) const {
+            auto perLayer = (size_t)(chunksX * chunksZ);
+            return glm::ivec3((int)(index % (size_t)chunksX), (int)(index / perLayer), (int)((index / (size_t)chunksX) % (size_t)chunksZ));
+        }
+
+        /**
+         * @brief Flags the chunk holding the given co-ordinates as needing a new mesh. Does nothing if out of bounds
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         */
+        void markDirty(int x, int y, int z) {
+            if (isOutOfBounds(x, y, z)) return;
+            if (auto section = findChunk(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)) {
+                markChunkDirty(*section, chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE));
+            }
+        }
+
+        /**
+         * @brief Flags the given chunk as needing a new mesh and adds it to dirtyChunks if it isn't
+         * already waiting there
+         * 
+         * @param section 
+         * @param index chunkIndex of the chunk
+         */
+        void markChunkDirty(chunk_t &section, size_t index) {
+            section.dirty = true;
+            if (!section.queued) {
+                section.queued = true;
+                dirtyChunks.push_back(index);
+            }
+        }
+
+        /**
+         * @brief Approximate number of bytes used to store the terrain
+         * 
+         * @return size_t 
+         */
+        size_t memoryUsage() const;
+    };
+}
+
+#endif //COMP3421_ASS3_CHUNK_HPP
@@ -0,0 +1,99 @@
+#ifndef COMP3421_ASS3_INSTANCER_HPP
+#define COMP3421_ASS3_INSTANCER_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <ass3/static_mesh.hpp>
+#include <ass3/chunk.hpp>
+
+#include <vector>
+
+namespace instancer {
+
+    // Attribute locations of the per-instance data, after the packed chunk vertex
+    const GLuint INSTANCE_POSITION_LOCATION = 4;
+    const GLuint INSTANCE_DATA_LOCATION = 5;
+
+    // One block drawn through the instanced path, decoded in default.vert, shadow.vert and
+    // cubeReflection.vert
+    // position: centre of the block
+    // data:     bits 0-5 faces to draw in world space (see chunk::ALL_FACES), bits 6-11 quarter
+    //           turns around x, y and z (2 bits each), bits 12-19 texture layer (the block type
+    //           ID), bit 20 illuminating
+    struct instance_t {
+        glm::vec3 position = glm::vec3(0.0f);
+        uint32_t data = 0;
+    };
+    static_assert(sizeof(instance_t) == 16, "block instances must stay 16 bytes");
+
+    // Blocks which aren't baked into chunk meshes, drawn as copies of one cube. The instances are
+    // filled on the CPU each pass and uploaded together
+    struct instanceBuffer_t {
+        static_mesh::mesh_t cube;
+        GLuint vbo = 0;
+        size_t capacity = 0;
+        std::vector<instance_t> instances;
+        // Number of instances in the last upload
+        GLsizei uploaded = 0;
+    };
+
+    /**
+     * @brief Packs the data of a block instance, see instance_t. Rotations are rounded to
+     * quarter turns, which is all rotatable blocks use
+     * 
+     * @param rotation in degrees, applied around x, then y, then z
+     * @param faces 
+     * @param layer 
+     * @param illuminating 
+     * @return uint32_t 
+     */
+    uint32_t packInstance(glm::vec3 rotation, uint8_t faces, uint8_t layer, bool illuminating);
+
+    /**
+     * @brief Makes the cube mesh and the instance buffer, with the per-instance attributes added
+     * to the cube's VAO. Must be called on the thread that owns the GL context
+     * 
+     * @param buffer 
+     */
+    void init(instanceBuffer_t &buffer);
+
+    /**
+     * @brief Adds a block to be drawn by the next upload
+     * 
+     * @param buffer 
+     * @param position 
+     * @param rotation 
+     * @param faces 
+     * @param blockID 
+     * @param illuminating 
+     */
+    void add(instanceBuffer_t &buffer, glm::vec3 position, glm::vec3 rotation, uint8_t faces, uint8_t blockID, bool illuminating);
+
+    /**
+     * @brief Gives the added instances to the GPU in the order they were added, replacing the
+     * last upload
+     * 
+     * @param buffer 
+     */
+    void upload(instanceBuffer_t &buffer);
+
+    /**
+     * @brief Points the per-instance attributes at the given instance, so the next instanced draw
+     * starts from it. OpenGL 3.3 has no base instance, so this is how a single one is picked.
+     * The cube's VAO must be bound
+     * 
+     * @param buffer 
+     * @param first 
+     */
+    void bindInstances(const instanceBuffer_t &buffer, GLint first);
+
+    /**
+     * @brief Frees the cube mesh and the instance buffer
+     * 
+     * @param buffer 
+     */
+    void destroy(instanceBuffer_t &buffer);
+}
+
+#endif //COMP3421_ASS3_INSTANCER_HPP
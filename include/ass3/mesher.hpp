@@ -0,0 +1,120 @@
+#ifndef COMP3421_ASS3_MESHER_HPP
+#define COMP3421_ASS3_MESHER_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <ass3/static_mesh.hpp>
+#include <ass3/chunk.hpp>
+#include <ass3/blocks.hpp>
+
+#include <vector>
+
+namespace mesher {
+
+    // Distance from the centre of a chunk to its corners
+    const float CHUNK_RADIUS = 13.86f;
+
+    // Every chunk mesh vertex is squeezed into 8 bytes, decoded in default.vert and shadow.vert.
+    // position: bits 0-14 corner x, y and z inside the chunk (0 to 16, 5 bits each), bits 15-17
+    //           face normal index (7 for unlit faces), bits 18-20 segment of the texture strip
+    // texture:  bits 0-5 u and bits 6-11 v in whole blocks (stored plus 16), bits 12-19 texture
+    //           layer (the block type ID), bits 20-27 light level
+    struct packedVertex_t {
+        uint32_t position = 0;
+        uint32_t texture = 0;
+    };
+    static_assert(sizeof(packedVertex_t) == 8, "chunk mesh vertices must stay 8 bytes");
+
+    // The baked exposed faces of every block in a chunk. Vertices are relative to the chunk's corner
+    // and indices are GLushort, a chunk never has more than 52224 visible face corners
+    struct chunkMesh_t {
+        static_mesh::mesh_t mesh;
+        // Cell index of every baked block with at least one visible face
+        std::vector<uint16_t> surfaceCells;
+        // Cell index of every visible block which is drawn on its own instead of being baked, and
+        // which of its faces can be seen
+        std::vector<uint16_t> specialCells;
+        std::vector<uint8_t> specialFaces;
+        glm::ivec3 origin = glm::ivec3(0);
+        glm::vec3 centre = glm::vec3(0.0f);
+        size_t totalVertices = 0;
+        // Vertex data made by meshChunk which hasn't been given to the GPU yet, see uploadChunkMesh
+        std::vector<packedVertex_t> vertices;
+        std::vector<GLushort> indices;
+        bool needsUpload = false;
+    };
+
+    /**
+     * @brief Checks if blocks of the given type are baked into chunk meshes. Transparent, mirror and
+     * rotatable blocks are drawn on their own instead
+     * 
+     * @param block 
+     * @return true 
+     * @return false 
+     */
+    inline bool isBaked(const blocks::properties_t &block) {
+        return !block.transparent && !block.mirror && !block.rotatable;
+    }
+
+    /**
+     * @brief Packs a chunk mesh vertex, see packedVertex_t
+     * 
+     * @param corner 
+     * @param normal 
+     * @param segment 
+     * @param texCoord 
+     * @param layer 
+     * @param light 
+     * @return packedVertex_t 
+     */
+    packedVertex_t packVertex(glm::ivec3 corner, uint32_t normal, uint32_t segment, glm::ivec2 texCoord, uint8_t layer, uint8_t light);
+
+    /**
+     * @brief Works out the vertex data of the chunk at the given chunk co-ordinates without touching
+     * OpenGL, so it can run on any thread. The GL buffers in chunkMesh are left alone until
+     * uploadChunkMesh is called. Only faces found by terrain_t::findFaceMasks are kept.
+     * With greedy on, neighbouring faces of the same block type are merged into larger quads. The
+     * texture co-ordinates count whole blocks, so the default shader repeats the texture per block
+     * 
+     * @param chunkMesh 
+     * @param terrain 
+     * @param registry 
+     * @param chunkX 
+     * @param chunkY 
+     * @param chunkZ 
+     * @param greedy 
+     */
+    void meshChunk(chunkMesh_t &chunkMesh, const chunk::terrain_t &terrain, const blocks::registry_t &registry, int chunkX, int chunkY, int chunkZ, bool greedy = false);
+
+    /**
+     * @brief Replaces the GL buffers of the given chunk mesh with the vertex data made by meshChunk,
+     * then frees that data. Must be called on the thread that owns the GL context
+     * 
+     * @param chunkMesh 
+     */
+    void uploadChunkMesh(chunkMesh_t &chunkMesh);
+
+    /**
+     * @brief Rebuilds the mesh of the chunk at the given chunk co-ordinates, replacing whatever was
+     * in chunkMesh. Same as meshChunk followed by uploadChunkMesh
+     * 
+     * @param chunkMesh 
+     * @param terrain 
+     * @param registry 
+     * @param chunkX 
+     * @param chunkY 
+     * @param chunkZ 
+     * @param greedy 
+     */
+    void buildChunkMesh(chunkMesh_t &chunkMesh, const chunk::terrain_t &terrain, const blocks::registry_t &registry, int chunkX, int chunkY, int chunkZ, bool greedy = false);
+
+    /**
+     * @brief Frees the GL buffers of the given chunk mesh
+     * 
+     * @param chunkMesh 
+     */
+    void destroy(chunkMesh_t &chunkMesh);
+}
+
+#endif //COMP3421_ASS3_MESHER_HPP
@@ -0,0 +1,132 @@
+#ifndef COMP3421_ASS3_PAGER_HPP
+#define COMP3421_ASS3_PAGER_HPP
+
+#include <glm/glm.hpp>
+
+#include <ass3/chunk.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace pager {
+
+    // Fills a newly made chunk at the given chunk co-ordinates. Called on the pager's thread
+    typedef std::function<void(chunk::chunk_t &section, glm::ivec3 chunkPos)> generator_t;
+
+    // A chunk that has finished loading and is waiting to be given to the terrain
+    struct loaded_t {
+        size_t index = 0;
+        chunk::chunk_t section;
+    };
+
+    // Loads chunks on a background thread, either by generating them or by restoring the chunks
+    // the player edited before they were paged out. Evicted chunks are handed back to the same
+    // thread, which keeps the edited ones and frees the rest. Every function other than the
+    // generator is called from the main thread
+    struct pager_t {
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+
+        // Jobs are done in the order they were given, so a chunk evicted and then requested
+        // again is always saved before it is loaded
+        struct job_t {
+            size_t index = 0;
+            bool evict = false;
+            chunk::chunk_t section;
+        };
+        std::deque<job_t> jobs;
+        std::vector<loaded_t> loaded;
+
+        // Chunks requested but not yet collected. Only touched by the main thread
+        std::unordered_set<size_t> pending;
+        // Edited chunks that have been paged out, keyed by chunkIndex. Only touched by the worker.
+        // Their rows are dropped and rebuilt when they come back
+        std::unordered_map<size_t, chunk::chunk_t> saved;
+
+        const chunk::terrain_t *terrain = nullptr;
+        generator_t generator;
+
+        pager_t() = default;
+        pager_t(const pager_t &) = delete;
+        pager_t &operator=(const pager_t &) = delete;
+        ~pager_t() {
+            stop();
+        }
+
+        /**
+         * @brief Starts the background thread. The terrain is only used for its layout and block
+         * flags, which must not change while the pager is running
+         * 
+         * @param pagedTerrain 
+         * @param chunkGenerator 
+         */
+        void start(const chunk::terrain_t &pagedTerrain, generator_t chunkGenerator);
+
+        /**
+         * @brief Stops the background thread once the job it is on is done, dropping the rest
+         * 
+         */
+        void stop();
+
+        /**
+         * @brief Checks if the background thread is running
+         * 
+         * @return true 
+         * @return false 
+         */
+        bool isRunning() const {
+            return worker.joinable();
+        }
+
+        /**
+         * @brief Queues the chunk with the given chunkIndex to be loaded. Does nothing if it has
+         * already been requested
+         * 
+         * @param index 
+         */
+        void request(size_t index);
+
+        /**
+         * @brief Checks if the chunk with the given chunkIndex has been requested but not collected
+         * 
+         * @param index 
+         * @return true 
+         * @return false 
+         */
+        bool isPending(size_t index) const {
+            return pending.count(index) != 0;
+        }
+
+        /**
+         * @brief Hands a chunk taken out of the terrain to the background thread to be saved or freed.
+         * Any lights and textures belonging to it must already be released
+         * 
+         * @param index 
+         * @param section 
+         */
+        void evict(size_t index, chunk::chunk_t section);
+
+        /**
+         * @brief Takes every chunk that has finished loading since the last call
+         * 
+         * @return std::vector<loaded_t> 
+         */
+        std::vector<loaded_t> collect();
+
+        /**
+         * @brief Runs jobs until stop is called. This is the background thread
+         * 
+         */
+        void run();
+    };
+}
+
+#endif //COMP3421_ASS3_PAGER_HPP
@@ -13,6 +13,8 @@ namespace particle {
         static_mesh::mesh_t mesh;
         GLuint textureID = 0;
         glm::vec3 translation = glm::vec3(0.0f);
+        // Where the particle was at the start of the last tick, so it can be drawn between ticks
+        glm::vec3 previousTranslation = glm::vec3(0.0f);
         glm::vec3 scale = glm::vec3(1.0f);
         glm::vec3 color = glm::vec3(0.0f);
         std::string name;
@@ -108,19 +110,26 @@ namespace particle {
     void spawnAmbientParticle(std::vector<particle_t *> *list, glm::vec3 position, GLuint texID, float minHeight = -999.0f);
 
     /**
-     * @brief All particles in the given list will be drawn with the given render. The gravity given here determines how fast the particles
-     * will fall. Set animate to true to also animate the particle, false if otherwise. Particles out of time will be freed and removed
-     * from the list
+     * @brief All particles in the given list will be drawn with the given render, each placed alpha of the way
+     * from where it was at the start of the last tick to where it is now
      * 
      * @param list 
      * @param defaultRender 
      * @param view 
      * @param proj 
+     * @param alpha 
+     */
+    void drawAllParticles(std::vector<particle_t *> *list, const renderer::renderer_t &defaultRender, glm::mat4 view, glm::mat4 proj, GLfloat alpha);
+
+    /**
+     * @brief Moves every particle in the given list forward by one tick. The gravity given here determines how fast the
+     * particles will fall. Particles out of time will be freed and removed from the list
+     * 
+     * @param list 
      * @param gravity 
      * @param dt 
-     * @param animate 
      */
-    void drawAllParticles(std::vector<particle_t *> *list, renderer::renderer_t defaultRender, glm::mat4 view, glm::mat4 proj, GLfloat gravity, GLfloat dt, bool animate = true);
+    void animateAllParticles(std::vector<particle_t *> *list, GLfloat gravity, GLfloat dt);
 
     /**
      * @brief Animates the praticles and also subtracts the deltatime from the particle's lifespan
@@ -7,13 +7,19 @@
 
 #include <chicken3421/chicken3421.hpp>
 
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 
 #define MAX_LIGHTS 101
 
 namespace renderer {
 
+	// Binding points of the uniform blocks shared by every program that declares them
+	const GLuint FRAME_BLOCK_BINDING = 0;
+	const GLuint LIGHT_BLOCK_BINDING = 1;
+
 	struct lightSource {
 		glm::vec3 position;
 		glm::vec3 diffuse;
@@ -21,18 +27,80 @@ namespace renderer {
 		glm::vec3 specular = glm::vec3(1.1f);
 		float intensity = 1.0f;
 
-		GLint position_loc;
-		GLint diffuse_loc;
-		GLint ambient_loc;
-		GLint specular_loc;
-		GLint intensity_loc;
-
 		bool occupied = false;
 	};
 
-	struct renderer_t {
+	// The FrameData uniform block, laid out by std140. The camera part is rewritten whenever the
+	// camera changes between passes, the rest once per frame
+	struct frameBlock_t {
+		glm::mat4 viewProj = glm::mat4(1.0f);
+		glm::mat4 lightProj = glm::mat4(1.0f);
+		glm::vec3 cameraPos = glm::vec3(0.0f);
+		float padding = 0.0f;
+		// Same layout as DirLight in the shaders
+		glm::vec3 sunDirection = glm::vec3(0.0f);
+		float padding2 = 0.0f;
+		glm::vec3 sunColor = glm::vec3(0.0f);
+		float sunAmbient = 0.0f;
+	};
+	static_assert(sizeof(frameBlock_t) == 176, "frameBlock_t must match the std140 layout of FrameData");
+
+	// One element of allLights in the LightData uniform block, laid out by std140
+	struct lightBlock_t {
+		glm::vec3 position = glm::vec3(-1.0f);
+		float padding = 0.0f;
+		glm::vec3 diffuse = glm::vec3(0.0f);
+		float padding2 = 0.0f;
+		glm::vec3 ambient = glm::vec3(0.0f);
+		float padding3 = 0.0f;
+		glm::vec3 specular = glm::vec3(0.0f);
+		float intensity = 0.0f;
+	};
+	static_assert(sizeof(lightBlock_t) == 64, "lightBlock_t must match the std140 layout of SpotLight");
+
+	// The kinds of pass things are drawn in. The draw functions take the pass as a template
+	// parameter, so what each pass binds and culls is decided once at compile time
+	enum class pass_t {
+		shadow,  // Depth from the sun through the shadow program, nothing is culled to the camera
+		color,   // The default program with every texture bound
+		bloom,   // The default program with only the glowing textures bound
+		cubemap, // The default program rendering a reflection, nothing is culled to the camera
+		plain,   // Any other program, only the geometry is drawn
+	};
 
-		std::string type = "";
+	/**
+	 * @brief Checks if the given pass draws with the default program, which needs materials and
+	 * textures bound
+	 * 
+	 * @param pass 
+	 * @return true 
+	 * @return false 
+	 */
+	constexpr bool isTextured(pass_t pass) {
+		return pass == pass_t::color || pass == pass_t::bloom || pass == pass_t::cubemap;
+	}
+
+	// A uniform name, kept only as its FNV-1a hash. Made straight from string literals so the
+	// hash of every name written in the code is folded in at compile time, and looked up in the
+	// program's uniform table without building any strings
+	struct uniform_t {
+		uint32_t hash = 2166136261u;
+
+		constexpr uniform_t() = default;
+
+		template <size_t N>
+		constexpr uniform_t(const char (&name)[N]) {
+			append(name);
+		}
+
+		constexpr void append(const char *text) {
+			for (; *text; text++) {
+				hash = (hash ^ (uint8_t)*text) * 16777619u;
+			}
+		}
+	};
+
+	struct renderer_t {
 
 		glm::mat4 projection;
 		glm::vec3 sun_light_dir = glm::normalize(glm::vec3(0) - glm::vec3(0, 10, 0));
@@ -48,18 +116,7 @@ namespace renderer {
 		
 		bool isShadowProgram = false;
 		// vertex shader uniforms
-		GLint view_proj_loc;
 		GLint model_loc;
-		GLint light_proj_loc;
-
-		GLint sun_direction_loc;
-		GLint sun_color_loc;
-		GLint sun_ambient_loc;
-
-		GLint uTex_loc;
-		GLint uSpec_loc;
-		GLint uDepth_loc;
-		GLuint uCube_loc;
 
 		GLint mat_tex_factor_loc;
 		GLint mat_specular_factor_loc;
@@ -68,9 +125,15 @@ namespace renderer {
 		GLint mat_diffuse_loc;
 		GLint mat_ambient_loc;
 		GLint phong_exponent_loc;
-		GLint camera_loc;
 		std::vector<lightSource> allLightSources;
 		int totalPointLights = 0;
+		// The shared uniform buffers, only made by the program that calls initialise
+		GLuint frameUBO = 0;
+		GLuint lightUBO = 0;
+		frameBlock_t frameBlock;
+		bool lightsChanged = true;
+		// Location of every active uniform of the program, keyed by uniform_t::hash
+		std::unordered_map<uint32_t, GLint> uniformLocations;
 
 
 		/**
@@ -78,7 +141,6 @@ namespace renderer {
 		 * 
 		 */
 		void createProgram(std::string programName) {
-			type = programName;
 			chicken3421::delete_program(program);
 			std::string directory = "res/shaders/" + programName;
 			auto vs = chicken3421::make_shader(directory + ".vert", GL_VERTEX_SHADER);
@@ -86,11 +148,82 @@ namespace renderer {
 			program = chicken3421::make_program(vs, fs);
 			chicken3421::delete_shader(vs);
 			chicken3421::delete_shader(fs);
+			findUniforms();
+			bindBlocks();
+		}
+
+		/**
+		 * @brief Points the FrameData and LightData uniform blocks of the program, if it has them,
+		 * at their shared binding points
+		 * 
+		 */
+		void bindBlocks() const {
+			auto frameIndex = glGetUniformBlockIndex(program, "FrameData");
+			if (frameIndex != GL_INVALID_INDEX) {
+				glUniformBlockBinding(program, frameIndex, FRAME_BLOCK_BINDING);
+			}
+			auto lightIndex = glGetUniformBlockIndex(program, "LightData");
+			if (lightIndex != GL_INVALID_INDEX) {
+				glUniformBlockBinding(program, lightIndex, LIGHT_BLOCK_BINDING);
+			}
+		}
+
+		/**
+		 * @brief Fills uniformLocations with every active uniform of the program. Arrays of plain
+		 * types are listed once by the driver as name[0], so each of their elements is added too
+		 * 
+		 */
+		void findUniforms() {
+			uniformLocations.clear();
+			GLint total = 0, longest = 0;
+			glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &total);
+			glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &longest);
+			std::vector<GLchar> name((size_t)longest + 1);
+
+			auto add = [this](const std::string &uniformName, GLint location) {
+				uniform_t uniform;
+				uniform.append(uniformName.c_str());
+				auto inserted = uniformLocations.emplace(uniform.hash, location);
+				if (!inserted.second && inserted.first->second != location) {
+					std::cout << "ERROR: Uniform " << uniformName << " has the same hash as another uniform\n";
+				}
+			};
+
+			for (GLint i = 0; i < total; i++) {
+				GLsizei length = 0;
+				GLint size = 0;
+				GLenum type = 0;
+				glGetActiveUniform(program, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+				std::string uniformName(name.data(), (size_t)length);
+				auto location = glGetUniformLocation(program, uniformName.c_str());
+				add(uniformName, location);
+
+				auto bracket = uniformName.size() >= 3 ? uniformName.size() - 3 : std::string::npos;
+				if (bracket != std::string::npos && uniformName.compare(bracket, 3, "[0]") == 0) {
+					auto base = uniformName.substr(0, bracket);
+					add(base, location);
+					for (GLint element = 1; element < size; element++) {
+						auto elementName = base + "[" + std::to_string(element) + "]";
+						add(elementName, glGetUniformLocation(program, elementName.c_str()));
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Finds the location of the given uniform, -1 if the program doesn't use it.
+		 * Setting a uniform at -1 does nothing, same as with glGetUniformLocation
+		 * 
+		 * @param uniform 
+		 * @return GLint 
+		 */
+		GLint location(uniform_t uniform) const {
+			auto found = uniformLocations.find(uniform.hash);
+			return found == uniformLocations.end() ? -1 : found->second;
 		}
 
 		void setUpShadow() {
-			light_proj_loc = chicken3421::get_uniform_location(program, "uLightProj");
-			model_loc = chicken3421::get_uniform_location(program, "uModel");
+			model_loc = location("uModel");
 		}
 
 		/**
@@ -102,74 +235,133 @@ namespace renderer {
 		void initialise(int width, int height) {
 
 			// Gets MVP_Loc
-			view_proj_loc = chicken3421::get_uniform_location(program, "uViewProj");
-			light_proj_loc = chicken3421::get_uniform_location(program, "uLightProj");
-			model_loc = chicken3421::get_uniform_location(program, "uModel");
+			model_loc = location("uModel");
 
-			uTex_loc = chicken3421::get_uniform_location(program, "uTex");
-			uSpec_loc = chicken3421::get_uniform_location(program, "uSpec");
-			uDepth_loc = chicken3421::get_uniform_location(program, "uDepthMap");
+			// Pointing to the different textures
+			activate();
+			setInt("uTex", 0);
+			setInt("uSpec", 1);
+			setInt("uDepthMap", 2);
+			setInt("uBlockTex", 3);
+			setInt("uBlockSpec", 4);
 
 			// Get projection
 			projection = glm::perspective(glm::radians(60.0), (double) width / (double) height, 0.1, 200.0);
-			// sunlight uniform locations
-			sun_direction_loc = chicken3421::get_uniform_location(program, "uSun.direction");
-			sun_color_loc = chicken3421::get_uniform_location(program, "uSun.color");
-			sun_ambient_loc = chicken3421::get_uniform_location(program, "uSun.ambient");
 
 			// material uniform locations
-			mat_ambient_loc = chicken3421::get_uniform_location(program, "uMat.ambient");
+			mat_ambient_loc = location("uMat.ambient");
 
-			mat_tex_factor_loc = chicken3421::get_uniform_location(program, "uMat.texFactor");
-			mat_color_loc = chicken3421::get_uniform_location(program, "uMat.color");
-			mat_diffuse_loc = chicken3421::get_uniform_location(program, "uMat.diffuse");
-			camera_loc =  chicken3421::get_uniform_location(program, "uCameraPos");
-			phong_exponent_loc = chicken3421::get_uniform_location(program, "uMat.phongExp");
-			mat_specular_factor_loc = chicken3421::get_uniform_location(program, "uMat.specularFactor");
-			mat_specular_loc = chicken3421::get_uniform_location(program, "uMat.specular");
+			mat_tex_factor_loc = location("uMat.texFactor");
+			mat_color_loc = location("uMat.color");
+			mat_diffuse_loc = location("uMat.diffuse");
+			phong_exponent_loc = location("uMat.phongExp");
+			mat_specular_factor_loc = location("uMat.specularFactor");
+			mat_specular_loc = location("uMat.specular");
 
 			for (int i = 0; i < MAX_LIGHTS; i++) {
 				lightSource light;
-				light.ambient_loc = chicken3421::get_uniform_location(program, "allLights[" + std::to_string(i) + "].ambient");
-				light.diffuse_loc = chicken3421::get_uniform_location(program, "allLights[" + std::to_string(i) + "].diffuse");
-				light.position_loc = chicken3421::get_uniform_location(program, "allLights[" + std::to_string(i) + "].position");
-				light.specular_loc = chicken3421::get_uniform_location(program, "allLights[" + std::to_string(i) + "].specular");
-				light.intensity_loc = chicken3421::get_uniform_location(program, "allLights[" + std::to_string(i) + "].intensity");
 				light.position = {-1, -1, -1};
 				allLightSources.push_back(light);
 			}
+
+			// The uniform buffers stay bound to their binding points for every program to read
+			glGenBuffers(1, &frameUBO);
+			glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+			glBufferData(GL_UNIFORM_BUFFER, sizeof(frameBlock_t), &frameBlock, GL_DYNAMIC_DRAW);
+			glGenBuffers(1, &lightUBO);
+			glBindBuffer(GL_UNIFORM_BUFFER, lightUBO);
+			glBufferData(GL_UNIFORM_BUFFER, sizeof(lightBlock_t) * MAX_LIGHTS, nullptr, GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, frameUBO);
+			glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, lightUBO);
+			lightsChanged = true;
+		}
+
+		/**
+		 * @brief Sets the camera every program draws with. Only uploaded if it differs from the
+		 * camera already in the frame block
+		 * 
+		 * @param viewProj 
+		 * @param pos 
+		 */
+		void setCamera(const glm::mat4 &viewProj, glm::vec3 pos) {
+			if (frameBlock.viewProj == viewProj && frameBlock.cameraPos == pos) return;
+			frameBlock.viewProj = viewProj;
+			frameBlock.cameraPos = pos;
+			uploadFrameBlock();
+		}
+
+		/**
+		 * @brief Uploads the sun and the light space matrix to the frame block, and the point lights
+		 * to the light block if any were added or removed. Called once per frame before drawing
+		 * 
+		 * @param lightProj 
+		 */
+		void updateBlocks(const glm::mat4 &lightProj) {
+			if (frameBlock.lightProj != lightProj || frameBlock.sunDirection != sun_light_dir ||
+				frameBlock.sunColor != sun_light_color || frameBlock.sunAmbient != sun_light_ambient) {
+				frameBlock.lightProj = lightProj;
+				frameBlock.sunDirection = sun_light_dir;
+				frameBlock.sunColor = sun_light_color;
+				frameBlock.sunAmbient = sun_light_ambient;
+				uploadFrameBlock();
+			}
+
+			if (!lightsChanged) return;
+			lightsChanged = false;
+			lightBlock_t lights[MAX_LIGHTS];
+			for (size_t i = 0; i < allLightSources.size() && i < MAX_LIGHTS; i++) {
+				lights[i].position = allLightSources[i].position;
+				lights[i].diffuse = allLightSources[i].diffuse;
+				lights[i].ambient = allLightSources[i].ambient;
+				lights[i].specular = allLightSources[i].specular;
+				lights[i].intensity = allLightSources[i].intensity;
+			}
+			glBindBuffer(GL_UNIFORM_BUFFER, lightUBO);
+			glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(lights), lights);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		}
+
+		/**
+		 * @brief Copies the whole frame block over to its uniform buffer
+		 * 
+		 */
+		void uploadFrameBlock() const {
+			glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+			glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frameBlock_t), &frameBlock);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
 		}
 
 		/**
 		 * @brief Uses this shader
 		 * 
 		 */
-		void activate() {
+		void activate() const {
 			glUseProgram(program);
 		}
 
-		void setInt(const std::string &name, int value) const {
-			glUniform1i(chicken3421::get_uniform_location(program, name.c_str()), value); 
+		void setInt(uniform_t name, int value) const {
+			glUniform1i(location(name), value); 
 		}
 
-		void setFloat(const std::string &name, float value) const { 
-			glUniform1fv(chicken3421::get_uniform_location(program, name.c_str()), 1, &value); 
+		void setFloat(uniform_t name, float value) const { 
+			glUniform1fv(location(name), 1, &value); 
 		}
 
-		void setMat4(const std::string &name, const glm::mat4 &mat) const {
-			glUniformMatrix4fv(chicken3421::get_uniform_location(program, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		void setMat4(uniform_t name, const glm::mat4 &mat) const {
+			glUniformMatrix4fv(location(name), 1, GL_FALSE, &mat[0][0]);
 		}
 
-		void setVec2(const std::string &name, const glm::vec2 &value) const { 
-			glUniform2fv(chicken3421::get_uniform_location(program, name.c_str()), 1, &value[0]); 
+		void setVec2(uniform_t name, const glm::vec2 &value) const { 
+			glUniform2fv(location(name), 1, &value[0]); 
 		}
 
-		void setVec3(const std::string &name, const glm::vec3 &value) const { 
-			glUniform3fv(chicken3421::get_uniform_location(program, name.c_str()), 1, &value[0]); 
+		void setVec3(uniform_t name, const glm::vec3 &value) const { 
+			glUniform3fv(location(name), 1, &value[0]); 
 		}
 
-		void setVec4(const std::string &name, const glm::vec4 &value) const { 
-			glUniform4fv(chicken3421::get_uniform_location(program, name.c_str()), 1, &value[0]);
+		void setVec4(uniform_t name, const glm::vec4 &value) const { 
+			glUniform4fv(location(name), 1, &value[0]);
 		}
 
 		/**
@@ -205,29 +397,6 @@ namespace renderer {
 			return MAX_LIGHTS;
 		}
 
-		/**
-		 * @brief Sets the base shader pointers
-		 * 
-		 * @param pos 
-		 */
-		void setBasePters(glm::vec3 pos) {
-			glUniform3fv(sun_direction_loc, 1, glm::value_ptr(sun_light_dir));
-            glUniform3fv(sun_color_loc, 1, glm::value_ptr(sun_light_color));
-            glUniform3fv(camera_loc, 1, glm::value_ptr(pos));
-            glUniform1f(sun_ambient_loc, sun_light_ambient);
-			for (auto light : allLightSources) {
-				glUniform3fv(light.ambient_loc, 1, glm::value_ptr(light.ambient));
-				glUniform3fv(light.diffuse_loc, 1, glm::value_ptr(light.diffuse));
-				glUniform3fv(light.specular_loc, 1, glm::value_ptr(light.specular));
-				glUniform3fv(light.position_loc, 1, glm::value_ptr(light.position));
-				glUniform1f(light.intensity_loc, light.intensity);
-			}
-            glUniform1i(uTex_loc, 0);
-			glUniform1i(uSpec_loc, 1);
-			glUniform1i(uDepth_loc, 2);
-			// Pointing to the different textures
-		}
-
 		/**
 		 * @brief Add a light source with the given parameters and returns the light ID used to create this light
 		 * 
@@ -240,6 +409,7 @@ namespace renderer {
 			for (size_t i = 0; i < allLightSources.size(); i++) {
 				if (!allLightSources[i].occupied) {
 					totalPointLights++;
+					lightsChanged = true;
 					std::cout << "\u001b[32mLight added.   " << MAX_LIGHTS - totalPointLights << " lights left.\n\033[0m";
 					allLightSources[i].occupied = true;
 					allLightSources[i].position = pos;
@@ -270,6 +440,7 @@ namespace renderer {
 		void removeLightSource(int lightID) {
 			if (lightID < 0) return;
 			totalPointLights--;
+			lightsChanged = true;
 			std::cout << "\u001b[31mLight removed. " << MAX_LIGHTS - totalPointLights << " lights left.\033[0m\n";
 			allLightSources[(size_t)lightID].occupied = false;
 			allLightSources[(size_t)lightID].position = {-1, -1, 1};
@@ -282,6 +453,9 @@ namespace renderer {
 		 */
 		void deleteProgram() {
 			chicken3421::delete_program(program);
+			if (frameUBO) glDeleteBuffers(1, &frameUBO);
+			if (lightUBO) glDeleteBuffers(1, &lightUBO);
+			frameUBO = lightUBO = 0;
 		}
 	};
 }
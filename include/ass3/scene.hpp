@@ -15,9 +15,15 @@
 #include <ass3/texture_2d.hpp>
 #include <ass3/renderer.hpp>
 #include <ass3/particle.hpp>
+#include <ass3/chunk.hpp>
+#include <ass3/blocks.hpp>
+#include <ass3/mesher.hpp>
+#include <ass3/pager.hpp>
+#include <ass3/instancer.hpp>
 
 #include <math.h>
 #include <vector>
+#include <unordered_map>
 #include <iostream>
 
 namespace scene {
@@ -27,10 +33,25 @@ namespace scene {
     const float JUMP_POWER_UNDERWATER = 4.0f;
     const float CAMERA_SPEED          = 5.0f;
     const float PLAYER_RADIUS         = 0.25f; // 0.25
+    // How far the player's box can sink into a block's face before it counts as overlapping it.
+    // Keeps the player from snagging on the blocks they are resting against
+    const float COLLISION_EPSILON     = 0.01f;
     const float SCREEN_DISTANCE       = 0.25f;
     const int   REFLECTION_SIZE       = 256;
     const int   VOID_LEVEL            = -5;
     const float ZFIGHT_OFFSET         = 0.02f;
+    // The world is simulated in ticks of a fixed length whatever the frame rate. Frames taking
+    // longer than MAX_TICKS_PER_FRAME ticks drop the rest of their time rather than catching up
+    const float TICK_LENGTH           = 1.0f / 60.0f;
+    const int   MAX_TICKS_PER_FRAME   = 5;
+    const float CLOUD_LEVEL           = 40.0f;
+    const int   CLOUD_TILES           = 4; // Times the cloud texture repeats across the clouds
+    // Width of unbounded worlds. Only the chunks around the player are kept loaded, this just
+    // bounds the chunk indices. Kept small enough that floats stay precise to a few thousandths
+    // of a block out at the edges
+    const int   UNBOUNDED_WIDTH       = 1 << 16;
+    const int   PAGE_MARGIN           = 1; // Chunks loaded past the render distance
+    const int   EVICT_MARGIN          = 2; // Chunks past the loaded area before a chunk is paged out
 
     const int   TOTAL_SMOKE           = 12;
     const int   TOTAL_FISH            = 14;
@@ -55,11 +76,13 @@ namespace scene {
         glm::vec3 rotation = glm::vec3(0.0);
         glm::vec3 scale = glm::vec3(1.0);
         std::vector<node_t> children;
-        std::vector<bool> culledFaces = {true, true, true, true, true, true};
+        // Faces to draw, see chunk::ALL_FACES
+        uint8_t visibleFaces = chunk::ALL_FACES;
         std::string name;
 
         int x = 0, y = 0, z = 0;
         int lightID = -1;
+        uint8_t blockID = chunk::AIR;
         bool air = true, transparent = false, illuminating = false, ignoreCulling = false;
     };
 
@@ -142,7 +165,7 @@ namespace scene {
             playerRightArm.air = false;
             // Creating block holding in hand
             scene::node_t blockInHand;
-            blockInHand.mesh = shapes::createCube(false, true);
+            blockInHand.mesh = shapes::getCube(false, true);
             blockInHand.scale *= 0.3f;
             blockInHand.textureID = blockTex;
             blockInHand.air = false;
@@ -254,11 +277,16 @@ namespace scene {
         GLuint texture = 0;
         GLuint specularMap = 0;
         GLuint bloomTexID = 0;
+        // Where the maps above were loaded from, so they can also be packed into texture arrays
+        std::string textureFile;
+        std::string specularFile;
+        std::string bloomFile;
         glm::vec3 rgb = {0, 0, 0};
         bool transparent = false;
         bool illuminating = false;
         bool rotatable = false;
         float intensity = 1.0f;
+        uint8_t id = chunk::AIR;
     };
 
     struct miniBlockData {
@@ -274,24 +302,55 @@ namespace scene {
     };
 
     /**
-     * @brief Render the given node and its children recursively. Renders selected sides based on
-     * the node's culled faces
+     * @brief Render the given node without its children. Renders selected sides based on the
+     * node's culled faces, and uses its bloom texture in the bloom pass. Only built for the bloom
+     * pass in scene.cpp, which draws the clouds with it
      * 
+     * @tparam Pass 
      * @param node 
      * @param model 
      * @param renderInfo 
      */
-    void drawBlock(const node_t *node, glm::mat4 model, renderer::renderer_t renderInfo, bool onlyIlluminating);
+    template <renderer::pass_t Pass>
+    void drawBlock(const node_t *node, glm::mat4 model, const renderer::renderer_t &renderInfo);
 
     /**
      * @brief Render the given node and its children recursively. Renders all sides regardless
-     * of culled faces
+     * of culled faces. Built for every renderer::pass_t in scene.cpp
      * 
+     * @tparam Pass 
      * @param node 
      * @param model 
      * @param renderInfo 
      */
-    void drawElement(const node_t *node, glm::mat4 model, renderer::renderer_t renderInfo);
+    template <renderer::pass_t Pass>
+    void drawElement(const node_t *node, glm::mat4 model, const renderer::renderer_t &renderInfo);
+
+    /**
+     * @brief Render the given chunk mesh in one call. Each vertex carries its block type's layer
+     * of the block texture arrays, which must already be bound, see world::bindBlockTextures.
+     * Built for every renderer::pass_t in scene.cpp
+     * 
+     * @tparam Pass 
+     * @param chunkMesh 
+     * @param model 
+     * @param renderInfo 
+     */
+    template <renderer::pass_t Pass>
+    void drawChunk(const mesher::chunkMesh_t *chunkMesh, glm::mat4 model, const renderer::renderer_t &renderInfo);
+
+    /**
+     * @brief Render the blocks last uploaded to the given instance buffer in one instanced call.
+     * Like drawChunk, the block texture arrays must already be bound. Built for every
+     * renderer::pass_t in scene.cpp
+     * 
+     * @tparam Pass 
+     * @param instances 
+     * @param model 
+     * @param renderInfo 
+     */
+    template <renderer::pass_t Pass>
+    void drawInstances(const instancer::instanceBuffer_t *instances, glm::mat4 model, const renderer::renderer_t &renderInfo);
 
     /**
      * @brief Takes in the parameters and returns blockData with all the information given stored inside
@@ -391,7 +450,8 @@ namespace scene {
     struct world {
 
         size_t worldWidth = 110;
-        const size_t WORLD_HEIGHT = 50;
+        // Made of CHUNK_SIZE high sections, the empty ones are skipped by scans and never meshed
+        const size_t WORLD_HEIGHT = 256;
         size_t seaSize = 0, cloudSize = 0;
         GLfloat cloudOffset = 0, cloudOriginalZ = 0;
         
@@ -404,19 +464,60 @@ namespace scene {
         bool cutsceneEnabled = false, useReflectionCam = false, drawCelestials = true;;
         player::playerPOV playerCamera, cutsceneCamera, reflectionCamera;
         glm::vec3 oldPos, oldHandPos, oldHandRotation, lastRenderedPos;
-        int increments = 200;
-        int playerReachRange = 4 * increments;
+        // Where the player was at the start of the last tick and where the tick left them. The
+        // camera is drawn between the two, see interpolate
+        glm::vec3 previousPlayerPos = glm::vec3(0.0f), simulatedPlayerPos = glm::vec3(0.0f);
+        float playerReachRange = 4.0f;
+        // The block under the crosshair, cast at most once per frame from the player's camera and
+        // shared by the highlight and the mouse handlers. See findCursor
+        struct cursor_t {
+            bool valid = false;
+            glm::vec3 pos = glm::vec3(0.0f);
+            float yaw = 0.0f, pitch = 0.0f;
+            chunk::raycast_t ray;
+        } cursor;
         int groundLevel = -99999, aboveLevel = 99999;
         float cutsceneTick = 0;
         float swingCycle = -1.0f, walkCycle = 0.0f;
         std::vector<GLuint> moonPhases;
         size_t moonPhase = 0;
 
-        std::vector<std::vector<std::vector<node_t>>> terrain;
+        chunk::terrain_t terrain;
+        // Index is the block type ID stored inside the terrain. Index 0 is air
+        std::vector<blockData> blockTypes;
+        // The maps of every block type packed into one array texture each, layer is the block type ID
+        GLuint blockTextureArray = 0;
+        GLuint blockSpecularArray = 0;
+        GLuint blockBloomArray = 0;
+        blocks::registry_t blockRegistry;
+        // Keyed by terrain_t::chunkIndex, only chunks that have come into render distance have one
+        std::unordered_map<size_t, mesher::chunkMesh_t> chunkMeshes;
+        std::vector<const mesher::chunkMesh_t *> chunksToRender;
+        // Chunk co-ordinates of the corners of the box of chunks in chunksToRender
+        glm::ivec3 minRenderedChunk = glm::ivec3(0), maxRenderedChunk = glm::ivec3(-1);
+        // Merges faces in chunk meshes, turned on for worlds built out of whole layers
+        bool greedyMeshing = false;
+        // Boxes (inclusive corners) of illuminating blocks placed by bulk edits, given lights on commitEdits
+        std::vector<std::pair<glm::ivec3, glm::ivec3>> pendingLights;
+
+        // A box (inclusive corners) of the preset world filled with one block type
+        struct fill_t {
+            glm::ivec3 from, to;
+            uint8_t id;
+            bool illuminating;
+        };
+        // Unbounded worlds page chunks in and out around the player instead of building them all up front
+        bool unbounded = false;
+        // The preset world, kept so chunks can be generated as they are paged in
+        std::vector<fill_t> presetFills;
+        // Gives lights to the illuminating blocks of paged in chunks
+        renderer::renderer_t *lightRenderer = nullptr;
         std::vector<particle::particle_t *> listOfParticles;
-        std::vector<node_t *> listOfBlocksToRender;
-        std::vector<node_t *> listOfTransBlocksToRender;
-        std::vector<node_t *> listOfShinyBlocksToRender;
+        std::vector<node_t> listOfBlocksToRender;
+        std::vector<node_t> listOfTransBlocksToRender;
+        std::vector<node_t> listOfShinyBlocksToRender;
+        // Refilled by every pass that draws one of the lists above
+        instancer::instanceBuffer_t blockInstances;
 
         node_t screen;
         node_t screenHand;
@@ -482,20 +583,35 @@ namespace scene {
         size_t handIndex = 0, hotbarHUDIndex = 0, flyingIconIndex = 0, moonIndex = 0, instructionIndex = 0;
         bool flyingMode = false, startSwingHandAnim = false, runningMode = false, hideScreen = false;
 
+        // Declared last so it is destroyed first, its thread generates chunks from the members above
+        pager::pager_t pager;
+
         /**
-         * @brief Creates a world with the given render distance and the world width
+         * @brief Creates a world with the given render distance and the world width. A width of 0
+         * makes an unbounded world, see pageChunks. The terrain is built on buildThreads threads,
+         * 0 to use one per core
          * 
          * @param listOfBlocks 
          * @param inputRenderDistance 
          * @param inputWidth 
+         * @param renderInfo 
+         * @param buildThreads 
          */
-        world(std::vector<miniBlockData> listOfBlocks, int inputRenderDistance, int inputWidth, renderer::renderer_t *renderInfo) {
+        world(std::vector<miniBlockData> listOfBlocks, int inputRenderDistance, int inputWidth, renderer::renderer_t *renderInfo, unsigned int buildThreads = 0) {
 
             renderDistance = inputRenderDistance;
-            worldWidth = (size_t)inputWidth;
-            terrain = {worldWidth , std::vector< std::vector<node_t> > (WORLD_HEIGHT, std::vector<node_t> (worldWidth) ) };
-            
-            std::cout << "Generating world of size " << worldWidth << "x" << worldWidth << " with render distance " << renderDistance << ". Please standby...\n";
+            unbounded = inputWidth <= 0;
+            worldWidth = unbounded ? (size_t)UNBOUNDED_WIDTH : (size_t)inputWidth;
+            lightRenderer = renderInfo;
+            auto startTime = glfwGetTime();
+            terrain.init((int)worldWidth, (int)WORLD_HEIGHT);
+            terrain.paged = unbounded;
+
+            if (unbounded) {
+                std::cout << "Generating unbounded world with render distance " << renderDistance << ". Please standby...\n";
+            } else {
+                std::cout << "Generating world of size " << worldWidth << "x" << worldWidth << " with render distance " << renderDistance << ". Please standby...\n";
+            }
             
             // SETTING UP BED SCENE GRAPH
             GLuint playerTex = texture_2d::init("./res/textures/player.png");
@@ -504,23 +620,28 @@ namespace scene {
             GLuint flyingIcon = texture_2d::init("./res/textures/flying_mode.png");
 
             // SETTING UP SEA FLOOR
-            seaSize = 100 * worldWidth;
-            cloudSize = 10 * worldWidth;
+            // An unbounded world's sea and clouds only need to cover the area paged in around the
+            // player, sizing them by the whole world loses float precision when sampling them
+            auto surfaceWidth = unbounded ? (size_t)getWorldSize() : worldWidth;
+            seaSize = 100 * surfaceWidth;
+            cloudSize = 10 * surfaceWidth;
             seaSurface = createFlatSurface(0, seaSize);
             seaSurface.translation.x = worldWidth / 2.0f;
             seaSurface.translation.z = worldWidth / 2.0f;
             seaSurface.translation.y = VOID_LEVEL + ZFIGHT_OFFSET;
 
             // SETTING UP CLOUDS
-            clouds = createFlatSurface(texture_2d::init("./res/textures/clouds.png"), 4);
+            clouds = createFlatSurface(texture_2d::init("./res/textures/clouds.png"), CLOUD_TILES);
             clouds.bloomTexID = texture_2d::init("./res/textures/clouds_bloom.png");
             clouds.translation.x = (float)worldWidth / 2.0f;
             cloudOriginalZ = clouds.translation.z;
             clouds.translation.z = (float)worldWidth / 2.0f;
-            clouds.translation.y = ((float)WORLD_HEIGHT * 0.8f) + ZFIGHT_OFFSET * 2;
+            clouds.translation.y = CLOUD_LEVEL + ZFIGHT_OFFSET * 2;
             clouds.scale *= glm::vec3(cloudSize, 1, cloudSize);
             clouds.ignoreCulling = true;
 
+            instancer::init(blockInstances);
+
             // SETTING UP CENTRE OF WORLD SCENE GRAPH
             // Setting up moon phases
             moonPhases.push_back(texture_2d::init("./res/textures/blocks/moon/moon_0.png"));
@@ -632,6 +753,8 @@ namespace scene {
             hotbarSecondary.push_back(combineBlockData("red", false, false));
             hotbarSecondary.push_back(combineBlockData("black", false, false));
 
+            registerBlockTypes();
+
             // Hand
             node_t blockHand = scene::createBlock(0, 0, 0, hotbar[0].texture, hotbar[0].specularMap, false, false, true);
             blockHand.translation.z = -1.0f * SCREEN_DISTANCE;
@@ -704,35 +827,133 @@ namespace scene {
             scrollHotbar(-1);
 
             // Generating the new world
-            for (size_t i = 0; i < listOfBlocks.size(); i++) {
-                
-                auto generatingBlock = findDataBlockName(listOfBlocks[i].blockName);
-                if (listOfBlocks[i].entireLayer) {
-                    // Fills up the entire y level if specified
-                    for (int x = 0; x < (int)terrain.size(); x++) {
-                        for (int z = 0; z < (int)terrain.at(0).at(0).size(); z++) {
-                            placeBlock(scene::createBlock(x, (int)listOfBlocks[i].position.y, z, generatingBlock, false, !generatingBlock.illuminating));
-                            if (generatingBlock.illuminating) {
-                                terrain.at(x).at(listOfBlocks[i].position.y).at(z).lightID = renderInfo->addLightSource(listOfBlocks[i].position, generatingBlock.rgb, generatingBlock.intensity);
-                            }
-                        }
+            auto threads = buildThreads ? buildThreads : utility::defaultThreadCount();
+            generateTerrain(listOfBlocks, threads);
+            commitEdits(renderInfo);
+            if (unbounded) {
+                pager.start(terrain, [this](chunk::chunk_t &section, glm::ivec3 chunkPos) {
+                    auto origin = chunkPos * chunk::CHUNK_SIZE;
+                    for (const auto &fill : presetFills) {
+                        terrain.fillChunk(section, fill.from - origin, fill.to - origin, fill.id);
                     }
+                });
+            } else {
+                // Mostly empty worlds such as sky block stay sparse, everything else is faster to read dense
+                terrain.setSparse(terrain.occupancy() < chunk::SPARSE_OCCUPANCY);
+            }
+            std::cout << "Terrain uses " << terrain.memoryUsage() / 1024 << "KB across " << terrain.totalChunks() << (terrain.sparse ? " sparse" : " dense") << " chunks\n";
+            std::cout << "World took " << glfwGetTime() - startTime << "s to create on " << threads << (threads == 1 ? " thread" : " threads") << " with " << static_mesh::totalGLObjects() << " mesh GL objects\n";
+            // Keeping track of where the hand and rotation is
+            oldHandPos = screenHand.children[handIndex].translation;
+            oldHandRotation = screenHand.children[handIndex].rotation;
+            std::cout << "World Created\n\n";
+        }
+
+        /**
+         * @brief Fills the terrain from the given preset blocks, then works out the face masks and
+         * mesh vertices of every chunk, all shared out by chunk between the given number of threads.
+         * Uploading the meshes is left for the main thread, which does it once each chunk comes into
+         * render distance. Unbounded worlds only build the chunks around the spawn point and keep
+         * the preset in presetFills for the pager
+         * 
+         * @param listOfBlocks 
+         * @param threads 
+         */
+        void generateTerrain(std::vector<miniBlockData> &listOfBlocks, unsigned int threads) {
+            auto &fills = presetFills;
+            fills.clear();
+            for (auto &block : listOfBlocks) {
+                auto generatingBlock = findDataBlockName(block.blockName);
+                fill_t fill;
+                fill.id = generatingBlock.id;
+                fill.illuminating = generatingBlock.illuminating;
+                if (block.entireLayer) {
+                    greedyMeshing = true;
+                    // Fills up the entire y level if specified
+                    fill.from = glm::ivec3(0, (int)block.position.y, 0);
+                    fill.to = glm::ivec3((int)worldWidth - 1, (int)block.position.y, (int)worldWidth - 1);
                 } else {
-                    if (listOfBlocks[i].startAtMiddle) {
+                    if (block.startAtMiddle) {
                         // Repositioning all the co-oridinates into the centre of the world if specified
-                        listOfBlocks[i].position += glm::vec3((float)terrain.size() / 2.0f, 0.0f, (float)terrain.at(0).at(0).size() / 2.0f);
+                        block.position += glm::vec3((float)worldWidth / 2.0f, 0.0f, (float)worldWidth / 2.0f);
                     }
-                    placeBlock(scene::createBlock((int)listOfBlocks[i].position.x, (int)listOfBlocks[i].position.y, (int)listOfBlocks[i].position.z, generatingBlock, false, !generatingBlock.illuminating));
-                    if (generatingBlock.illuminating) {
-                        terrain.at(listOfBlocks[i].position.x).at(listOfBlocks[i].position.y).at(listOfBlocks[i].position.z).lightID = renderInfo->addLightSource(listOfBlocks[i].position, generatingBlock.rgb, generatingBlock.intensity);
+                    fill.from = fill.to = glm::ivec3((int)block.position.x, (int)block.position.y, (int)block.position.z);
+                }
+                fill.from = glm::max(fill.from, glm::ivec3(0));
+                fill.to = glm::min(fill.to, glm::ivec3(terrain.width - 1, terrain.height - 1, terrain.width - 1));
+                if (fill.from.x > fill.to.x || fill.from.y > fill.to.y || fill.from.z > fill.to.z) continue;
+
+                fills.push_back(fill);
+            }
+
+            auto fromChunk = glm::ivec3(0), toChunk = glm::ivec3(terrain.chunksX - 1, terrain.chunksY - 1, terrain.chunksZ - 1);
+            if (unbounded) {
+                auto spawnChunk = (int)worldWidth / 2 / chunk::CHUNK_SIZE;
+                fromChunk = glm::ivec3(spawnChunk - pageRadius(), 0, spawnChunk - pageRadius());
+                toChunk = glm::ivec3(spawnChunk + pageRadius(), terrain.chunksY - 1, spawnChunk + pageRadius());
+            }
+            for (const auto &fill : fills) {
+                auto from = glm::max(fill.from, fromChunk * chunk::CHUNK_SIZE);
+                auto to = glm::min(fill.to, toChunk * chunk::CHUNK_SIZE + (chunk::CHUNK_SIZE - 1));
+                if (fill.illuminating && from.x <= to.x && from.y <= to.y && from.z <= to.z) {
+                    pendingLights.emplace_back(from, to);
+                }
+            }
+
+            // Every chunk that gets a block is stored (and given a mesh) up front, as neither
+            // container can grow from several threads at once
+            auto regionSize = toChunk - fromChunk + 1;
+            std::vector<bool> seen((size_t)regionSize.x * (size_t)regionSize.y * (size_t)regionSize.z, false);
+            std::vector<size_t> indices;
+            auto addChunks = [&](glm::ivec3 low, glm::ivec3 high) {
+                low = glm::max(low, fromChunk);
+                high = glm::min(high, toChunk);
+                for (int chunkY = low.y; chunkY <= high.y; chunkY++) {
+                    for (int chunkZ = low.z; chunkZ <= high.z; chunkZ++) {
+                        for (int chunkX = low.x; chunkX <= high.x; chunkX++) {
+                            auto local = glm::ivec3(chunkX, chunkY, chunkZ) - fromChunk;
+                            auto slot = ((size_t)local.y * (size_t)regionSize.z + (size_t)local.z) * (size_t)regionSize.x + (size_t)local.x;
+                            if (seen[slot]) continue;
+                            seen[slot] = true;
+                            indices.push_back(terrain.chunkIndex(chunkX, chunkY, chunkZ));
+                        }
                     }
                 }
-                terrain.at((size_t)listOfBlocks[i].position.x).at((size_t)listOfBlocks[i].position.y).at((size_t)listOfBlocks[i].position.z).transparent = generatingBlock.transparent;
+            };
+            if (unbounded) {
+                // Paged terrain stores empty chunks too, so they aren't mistaken for unloaded ones
+                addChunks(fromChunk, toChunk);
+            } else {
+                for (const auto &fill : fills) {
+                    addChunks(fill.from / chunk::CHUNK_SIZE, fill.to / chunk::CHUNK_SIZE);
+                }
             }
-            // Keeping track of where the hand and rotation is
-            oldHandPos = screenHand.children[handIndex].translation;
-            oldHandRotation = screenHand.children[handIndex].rotation;
-            std::cout << "World Created\n\n";
+            std::vector<chunk::chunk_t *> sections;
+            std::vector<mesher::chunkMesh_t *> meshes;
+            for (auto index : indices) {
+                auto origin = terrain.chunkPosition(index) * chunk::CHUNK_SIZE;
+                sections.push_back(&terrain.chunkAt(origin.x, origin.y, origin.z));
+                meshes.push_back(&chunkMeshes[index]);
+            }
+
+            // Filling has to finish on every chunk before meshing starts, as face masks look at the
+            // neighbouring chunks' blocks
+            utility::parallelFor(indices.size(), threads, [&](size_t i) {
+                auto origin = terrain.chunkPosition(indices[i]) * chunk::CHUNK_SIZE;
+                for (const auto &fill : fills) {
+                    terrain.fillChunk(*sections[i], fill.from - origin, fill.to - origin, fill.id);
+                }
+            });
+            // Chunks share heightmaps with the rest of their column, so those are done one by one
+            for (auto index : indices) {
+                auto chunkPos = terrain.chunkPosition(index);
+                terrain.refreshHeightmap(chunkPos.x, chunkPos.y, chunkPos.z);
+            }
+            utility::parallelFor(indices.size(), threads, [&](size_t i) {
+                auto chunkPos = terrain.chunkPosition(indices[i]);
+                mesher::meshChunk(*meshes[i], terrain, blockRegistry, chunkPos.x, chunkPos.y, chunkPos.z, greedyMeshing);
+                sections[i]->dirty = false;
+            });
         }
 
         /**
@@ -792,20 +1013,170 @@ namespace scene {
          * @return blockData 
          */
         blockData findDataBlockName(std::string blockName) {
-            for (size_t i = 0; i < hotbar.size(); i++) {
-                if (hotbar[i].blockName == blockName) {
-                    return hotbar[i];
-                }
-            }
-            for (size_t i = 0; i < hotbarSecondary.size(); i++) {
-                if (hotbarSecondary[i].blockName == blockName) {
-                    return hotbarSecondary[i];
-                }
+            auto id = blockRegistry.find(blockName);
+            if (id != chunk::AIR) {
+                return blockTypes[id];
             }
             std::cout << "ERROR: BLOCK NOT FOUND!\n";
             return hotbar.front();
         }
 
+        /**
+         * @brief Gives every block in both hotbars a block type ID and stores them in blockTypes.
+         * Must be called once both hotbars are filled
+         * 
+         */
+        void registerBlockTypes() {
+            blockTypes.clear();
+            blockRegistry.clear();
+            blockData air;
+            air.blockName = "air";
+            air.id = chunk::AIR;
+            blockTypes.push_back(air);
+            for (auto list : {&hotbar, &hotbarSecondary}) {
+                for (auto &data : *list) {
+                    data.id = blockRegistry.add(data.blockName, data.transparent, data.illuminating, data.rotatable, data.rgb, data.intensity);
+                    if (data.id == chunk::AIR) continue;
+                    const auto &block = blockRegistry[data.id];
+                    if (!block.mirror) {
+                        terrain.setBlockFlags(data.id, block.transparent ? chunk::GLASS_FLAG : chunk::OPAQUE_FLAG);
+                    }
+                    blockTypes.push_back(data);
+                }
+            }
+            buildBlockTextureArrays();
+        }
+
+        /**
+         * @brief Packs the maps of every block type in blockTypes into the block texture arrays,
+         * replacing any made before. Air's layer is left blank
+         * 
+         */
+        void buildBlockTextureArrays() {
+            destroyBlockTextureArrays();
+            std::vector<std::string> textureFiles, specularFiles, bloomFiles;
+            for (const auto &data : blockTypes) {
+                textureFiles.push_back(data.textureFile);
+                specularFiles.push_back(data.specularFile);
+                bloomFiles.push_back(data.bloomFile);
+            }
+            blockTextureArray = texture_2d::initArray(textureFiles);
+            blockSpecularArray = texture_2d::initArray(specularFiles);
+            blockBloomArray = texture_2d::initArray(bloomFiles);
+        }
+
+        /**
+         * @brief Frees the block texture arrays
+         * 
+         */
+        void destroyBlockTextureArrays() {
+            for (auto tex : {&blockTextureArray, &blockSpecularArray, &blockBloomArray}) {
+                if (*tex) texture_2d::destroy(*tex);
+                *tex = 0;
+            }
+        }
+
+        /**
+         * @brief Binds the block texture arrays the chunk meshes and block instances read from.
+         * Nothing else uses their texture units, so this is the only bind a terrain pass needs
+         * 
+         * @tparam Pass 
+         */
+        template <renderer::pass_t Pass>
+        void bindBlockTextures() {
+            if constexpr (renderer::isTextured(Pass)) {
+                glActiveTexture(GL_TEXTURE3);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, Pass == renderer::pass_t::bloom ? blockBloomArray : blockTextureArray);
+                glActiveTexture(GL_TEXTURE4);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, blockSpecularArray);
+                glActiveTexture(GL_TEXTURE0);
+            }
+        }
+
+        /**
+         * @brief Checks if the block at the given co-ordinates is air. Anything outside of the world is air
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return true if air
+         * @return false if there is a block
+         */
+        bool isAir(int x, int y, int z) {
+            return terrain.blockOrAir(x, y, z) == chunk::AIR;
+        }
+
+        /**
+         * @brief Gets the blockData of the block at the given co-ordinates. Air if outside of the world
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return const blockData& 
+         */
+        const blockData &getBlockType(int x, int y, int z) {
+            return blockTypes[terrain.blockOrAir(x, y, z)];
+        }
+
+        /**
+         * @brief Gets the properties of the block at the given co-ordinates. Air if outside of the world
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return const blocks::properties_t& 
+         */
+        const blocks::properties_t &getBlockProperties(int x, int y, int z) {
+            return blockRegistry[terrain.blockOrAir(x, y, z)];
+        }
+
+        /**
+         * @brief Remembers the light source belonging to the block at the given co-ordinates
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @param lightID 
+         */
+        void addBlockLight(int x, int y, int z, int lightID) {
+            if (lightID < 0 || terrain.isOutOfBounds(x, y, z)) return;
+            terrain.getInstance(x, y, z).lightID = lightID;
+        }
+
+        /**
+         * @brief Creates a node_t of the block at the given co-ordinates so it can be drawn.
+         * The node uses the shared cube mesh so nothing needs to be destroyed afterwards
+         * 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @return node_t 
+         */
+        node_t createTerrainNode(int x, int y, int z) {
+            const auto &data = getBlockType(x, y, z);
+            node_t block;
+            block.name = data.blockName;
+            block.air = false;
+            block.mesh = shapes::getCube(false, !data.illuminating);
+            block.textureID = data.texture;
+            block.specularID = data.specularMap;
+            block.bloomTexID = data.bloomTexID;
+            block.x = x;
+            block.y = y;
+            block.z = z;
+            block.transparent = data.transparent;
+            block.illuminating = data.illuminating;
+            block.ignoreCulling = data.rotatable;
+            block.translation = glm::vec3(x, y, z);
+            block.blockID = data.id;
+            if (auto instance = terrain.findInstance(x, y, z)) {
+                block.rotation = instance->rotation;
+                block.lightID = instance->lightID;
+                block.reflectionTexID = instance->reflectionTexID;
+            }
+            return block;
+        }
+
         /**
          * @brief Turns the display of the instructions on or off
          * 
@@ -884,10 +1255,9 @@ namespace scene {
             tempPos.x = round(pos.x);
             tempPos.z = round(pos.z);
             tempPos.y = round(pos.y - eyeLevel);
-            for (size_t i = tempPos.x - (size_t)1; i <= tempPos.x + 1; i++) {
-                for (size_t j = tempPos.z - (size_t)1; j <= tempPos.z + 1; j++) {
-                    if (isCoordOutBoundaries(i, tempPos.y, j)) continue;
-                    if (!terrain.at(i).at(tempPos.y).at(j).air) {
+            for (int i = (int)tempPos.x - 1; i <= (int)tempPos.x + 1; i++) {
+                for (int j = (int)tempPos.z - 1; j <= (int)tempPos.z + 1; j++) {
+                    if (terrain.isSolid(i, (int)tempPos.y, j)) {
                         return false;
                     }
                 }
@@ -979,18 +1349,53 @@ namespace scene {
          * Also changes the diffuse of the sky sphere.
          * 
          * @param degree 
-         * @param skyColor 
-         * @param dt 
          */
-        void updateSunPosition(float degree, float dt) {
+        void updateSunPosition(float degree) {
             worldTime = fmod(abs(degree / 360.0f), 1.0f);
             centreOfWorld.translation = playerCamera.pos;
             centreOfWorld.rotation = glm::vec3(0, 0, degree);
+        }
+
+        /**
+         * @brief Advances the player, particles and clouds by one tick of TICK_LENGTH seconds. The
+         * player's camera must be at its simulated position, so call this before interpolate
+         * 
+         * @param window 
+         * @param renderInfo 
+         */
+        void tick(GLFWwindow *window, renderer::renderer_t *renderInfo) {
+            previousPlayerPos = playerCamera.pos;
+            spawnBlockParticles();
+            if (!cutsceneEnabled) {
+                updatePlayerPositions(window, TICK_LENGTH, renderInfo);
+            }
+            particle::animateAllParticles(&listOfParticles, GRAVITY, TICK_LENGTH);
+
             // Move the cloud along
-            cloudOffset = fmod(cloudOffset + dt / ((cutsceneEnabled) ? 0.1f : 3.0f), cloudSize);
+            cloudOffset = fmod(cloudOffset + TICK_LENGTH / ((cutsceneEnabled) ? 0.1f : 3.0f), cloudSize);
             clouds.translation.z = cloudOriginalZ + cloudOffset;
         }
 
+        /**
+         * @brief Moves the player's camera alpha of the way from where it was at the start of the last
+         * tick to where that tick left it, for drawing a frame that lands between ticks. Call
+         * finishInterpolation once the frame is drawn
+         * 
+         * @param alpha 
+         */
+        void interpolate(float alpha) {
+            simulatedPlayerPos = playerCamera.pos;
+            playerCamera.pos = glm::mix(previousPlayerPos, simulatedPlayerPos, alpha);
+        }
+
+        /**
+         * @brief Puts the player's camera back where the last tick left it
+         * 
+         */
+        void finishInterpolation() {
+            playerCamera.pos = simulatedPlayerPos;
+        }
+
         /**
          * @brief Advances the bobbing hand animation based on the given delta time
          * 
@@ -1106,10 +1511,27 @@ namespace scene {
             player.changeBlockInHandTex(hotbar[hotbarIndex].texture, hotbar[hotbarIndex].specularMap);
         }
     
+        /**
+         * @brief Casts the player's view ray through the terrain, reusing the last cast if the
+         * camera hasn't moved since and no block has been changed this frame
+         * 
+         * @return const chunk::raycast_t& 
+         */
+        const chunk::raycast_t &findCursor() {
+            if (!cursor.valid || cursor.pos != playerCamera.pos || cursor.yaw != playerCamera.yaw || cursor.pitch != playerCamera.pitch) {
+                cursor.ray = terrain.raycast(playerCamera.pos, player::getLookingDirection(&playerCamera, 1), playerReachRange);
+                cursor.pos = playerCamera.pos;
+                cursor.yaw = playerCamera.yaw;
+                cursor.pitch = playerCamera.pitch;
+                cursor.valid = true;
+            }
+            return cursor.ray;
+        }
+
         /**
          * @brief Finds the block that the player is looking at within a certain limit.
-         * giveBlockBefore to return the location of the nieghbouring block which is closest
-         * to where the player was looking
+         * giveBlockBefore to return the location of the nieghbouring block whose face
+         * the player was looking at
          * 
          * @param giveBlockBefore 
          * @return glm::vec3 
@@ -1118,29 +1540,13 @@ namespace scene {
             // Don't bother if the cutscene is playing
             if (cutsceneEnabled) return glm::vec3(-1, -1, -1); 
 
-            glm::vec3 lookingDirection = player::getLookingDirection(&playerCamera, increments);
-            float rayX = playerCamera.pos.x, rayY = playerCamera.pos.y, rayZ = playerCamera.pos.z;
-
-            int limit = 0;
-            while (limit < playerReachRange) {
-    
-                rayX += lookingDirection.x;
-                rayY += lookingDirection.y;
-                rayZ += lookingDirection.z;
-                limit++;
-                
-                if (isCoordOutBoundaries((int)round(rayX), (int)round(rayY), (int)round(rayZ))) {
-                    continue;
-                } else if (!terrain.at((int)round(rayX)).at((int)round(rayY)).at((int)round(rayZ)).air) {
-                    break;
-                }
-            }
-            if (limit >= playerReachRange || isCoordOutBoundaries((int)round(rayX), (int)round(rayY), (int)round(rayZ))) {
+            const auto &ray = findCursor();
+            if (!ray.hit) {
                 return glm::vec3(-1, -1, -1);
             } else if (giveBlockBefore) {
-                return glm::vec3((int)round(rayX - lookingDirection.x), (int)round(rayY - lookingDirection.y), (int)round(rayZ - lookingDirection.z));
+                return glm::vec3(ray.block + ray.normal);
             }
-            return glm::vec3((int)round(rayX), (int)round(rayY), (int)round(rayZ));
+            return glm::vec3(ray.block);
         }
 
         /**
@@ -1155,52 +1561,51 @@ namespace scene {
             screenHand.children[handIndex].translation = oldHandPos;
             screenHand.children[handIndex].rotation = oldHandRotation;
 
-            size_t placeX, placeY, placeZ;
-
             auto placeBlockVector = findCursorBlock(true);
-            placeX = (size_t)placeBlockVector.x;
-            placeY = (size_t)placeBlockVector.y;
-            placeZ = (size_t)placeBlockVector.z;
-            
-            
-            if (isCoordOutBoundaries((int)placeX, (int)placeY, (int)placeZ)) {
+            int placeX = (int)placeBlockVector.x, placeY = (int)placeBlockVector.y, placeZ = (int)placeBlockVector.z;
+
+            if (terrain.isOutOfBounds(placeX, placeY, placeZ) || !terrain.isColumnLoaded(placeX, placeZ)) {
                 return;
             }
-            
-            if (terrain.at(placeX).at(placeY).at(placeZ).air) {
-                placeBlock(scene::createBlock((int)placeX, (int)placeY, (int)placeZ, hotbar[hotbarIndex], false, !hotbar[hotbarIndex].illuminating));
+
+            if (isAir(placeX, placeY, placeZ)) {
+                const auto &data = hotbar[hotbarIndex];
+                placeBlock(placeX, placeY, placeZ, data);
+                cursor.valid = false;
 
                 // Adding a light source to the block
-                if (terrain.at(placeX).at(placeY).at(placeZ).illuminating) {
-                    terrain.at(placeX).at(placeY).at(placeZ).lightID = renderInfo->addLightSource(glm::vec3(placeX, placeY, placeZ), hotbar[hotbarIndex].rgb, hotbar[hotbarIndex].intensity);
-                    
-                    if (terrain.at(placeX).at(placeY).at(placeZ).lightID < 0) {
+                if (data.illuminating) {
+                    auto lightID = renderInfo->addLightSource(glm::vec3(placeX, placeY, placeZ), data.rgb, data.intensity);
+                    addBlockLight(placeX, placeY, placeZ, lightID);
+
+                    if (lightID < 0) {
                         std::cout << "Maximum lights reached, can only have up to " << renderInfo->getMaxLights() << " point lights\n";
                     }
                 }
                 // If player is inside a block, then destroy the block
                 if (checkInsideBlock()) {
-                    renderInfo->removeLightSource(terrain.at(placeX).at(placeY).at(placeZ).lightID);
-                    terrain.at(placeX).at(placeY).at(placeZ).air = true;
-                    terrain.at(placeX).at(placeY).at(placeZ).transparent = true;
-                    terrain.at(placeX).at(placeY).at(placeZ).lightID = -1;
+                    if (auto instance = terrain.findInstance(placeX, placeY, placeZ)) {
+                        renderInfo->removeLightSource(instance->lightID);
+                    }
+                    terrain.setBlock(placeX, placeY, placeZ, chunk::AIR);
                     return;
                 } else {
-                    if (hotbar[hotbarIndex].rotatable && abs(playerCamera.pitch) <= 35.0f && !shiftMode) {
+                    if (data.rotatable && abs(playerCamera.pitch) <= 35.0f && !shiftMode) {
                         // Rotate the block if it is a block that can be rotated
                         // Blocks will not rotate if shift is being pressed
+                        auto &rotation = terrain.getInstance(placeX, placeY, placeZ).rotation;
                         switch (utility::getDirection(playerCamera.yaw)) {
                             case 0:
-                                terrain.at(placeX).at(placeY).at(placeZ).rotation = glm::vec3(90.0f, 0.0f, 0.0f);
+                                rotation = glm::vec3(90.0f, 0.0f, 0.0f);
                                 break;
                             case 1:
-                                terrain.at(placeX).at(placeY).at(placeZ).rotation = glm::vec3(0.0f, 0.0f, 90.0f);
+                                rotation = glm::vec3(0.0f, 0.0f, 90.0f);
                                 break;
                             case 2:
-                                terrain.at(placeX).at(placeY).at(placeZ).rotation = glm::vec3(-90.0f, 0.0f, 0.0f);
+                                rotation = glm::vec3(-90.0f, 0.0f, 0.0f);
                                 break;
                             case 3:
-                                terrain.at(placeX).at(placeY).at(placeZ).rotation = glm::vec3(0.0f, 0.0f, -90.0f);
+                                rotation = glm::vec3(0.0f, 0.0f, -90.0f);
                                 break;
                         }
                     }
@@ -1210,7 +1615,7 @@ namespace scene {
                 }
 
                 // If program reaches here, the blocks to be rendered must be updated
-                updateBlocksToRender(true);
+                updateDirtyChunks();
             }
         }
 
@@ -1233,26 +1638,23 @@ namespace scene {
             } else {
                 placeBlockVector = forcedPlace;
             }
-            size_t placeX = (size_t)placeBlockVector.x, placeY = (size_t)placeBlockVector.y, placeZ = (size_t)placeBlockVector.z;
-            
-            if (isCoordOutBoundaries((int)placeX, (int)placeY, (int)placeZ)) {
+            int placeX = (int)placeBlockVector.x, placeY = (int)placeBlockVector.y, placeZ = (int)placeBlockVector.z;
+
+            if (terrain.isOutOfBounds(placeX, placeY, placeZ)) {
                 return;
             }
 
-            if (!terrain.at(placeX).at(placeY).at(placeZ).air) {
+            if (!isAir(placeX, placeY, placeZ)) {
                 // Removes the block from the world and also spawns particles
-                auto blockTex = terrain.at(placeX).at(placeY).at(placeZ).textureID;
-                terrain.at(placeX).at(placeY).at(placeZ).textureID = 0;
-                texture_2d::destroy(terrain.at(placeX).at(placeY).at(placeZ).reflectionTexID);
-                terrain.at(placeX).at(placeY).at(placeZ).air = true;
-                terrain.at(placeX).at(placeY).at(placeZ).transparent = true;
-                terrain.at(placeX).at(placeY).at(placeZ).rotation = glm::vec3(0.0f, 0.0f, 0.0f);
-                if (terrain.at(placeX).at(placeY).at(placeZ).lightID != -1) {
-                    renderInfo->removeLightSource(terrain.at(placeX).at(placeY).at(placeZ).lightID);
-                    terrain.at(placeX).at(placeY).at(placeZ).lightID = -1;
+                auto blockTex = getBlockType(placeX, placeY, placeZ).texture;
+                if (auto instance = terrain.findInstance(placeX, placeY, placeZ)) {
+                    texture_2d::destroy(instance->reflectionTexID);
+                    renderInfo->removeLightSource(instance->lightID);
                 }
+                terrain.setBlock(placeX, placeY, placeZ, chunk::AIR);
+                cursor.valid = false;
                 // If program reaches here, the blocks to be rendered must be updated
-                updateBlocksToRender(true);
+                updateDirtyChunks();
                 particle::spawnBlockBreakParticles(&listOfParticles, placeBlockVector, blockTex);
                 if (isUnderwater(placeBlockVector)) {
                     particle::spawnFloatingParticles(&listOfParticles, placeBlockVector, bubble, seaSurface.translation.y);
@@ -1268,15 +1670,16 @@ namespace scene {
          */
         void middleClickPick() {
             auto placeBlockVector = findCursorBlock(false);
-            auto placeX = placeBlockVector.x, placeY = placeBlockVector.y, placeZ = placeBlockVector.z;
-            
-            if (isCoordOutBoundaries(placeX, placeY, placeZ)) {
+            int placeX = (int)placeBlockVector.x, placeY = (int)placeBlockVector.y, placeZ = (int)placeBlockVector.z;
+
+            if (terrain.isOutOfBounds(placeX, placeY, placeZ)) {
                 return;
             }
+            auto blockID = terrain.blockOrAir(placeX, placeY, placeZ);
             int index = 0;
             bool found = false;
             for (auto i : hotbar) {
-                if (i.texture == terrain.at(placeX).at(placeY).at(placeZ).textureID) {
+                if (i.id == blockID) {
                     hotbarIndex = index;
                     found = true;
                     break;
@@ -1287,7 +1690,7 @@ namespace scene {
             if (!found) {
                 index = 0;
                 for (auto i : hotbarSecondary) {
-                    if (i.texture == terrain.at(placeX).at(placeY).at(placeZ).textureID) {
+                    if (i.id == blockID) {
                         switchHotbars();
                         hotbarIndex = index;
                         break;
@@ -1300,19 +1703,96 @@ namespace scene {
         }
 
         /**
-         * @brief Places the block into the world using it's x, y, z values
+         * @brief Places the given block into the world at the given x, y, z values
          * 
-         * @param block 
+         * @param x 
+         * @param y 
+         * @param z 
+         * @param data 
          */
-        void placeBlock(node_t block) {
-            size_t blockX = (size_t)block.x, blockY = (size_t)block.y, blockZ = (size_t)block.z;
-            scene::destroy(&terrain.at(blockX).at(blockY).at(blockZ), false);
-            block.transparent = hotbar[(size_t)hotbarIndex].transparent;
-            block.illuminating = hotbar[(size_t)hotbarIndex].illuminating;
-            terrain.at(blockX).at(blockY).at(blockZ) = block;
+        void placeBlock(int x, int y, int z, const blockData &data) {
+            if (terrain.isOutOfBounds(x, y, z)) return;
+            terrain.setBlock(x, y, z, data.id);
             return;
         }
 
+        /**
+         * @brief Fills the entire y level with the given block. Like the other bulk edits, nothing
+         * derived from the blocks (face masks, meshes, render lists and lights) is updated until
+         * commitEdits is called
+         * 
+         * @param y 
+         * @param data 
+         */
+        void fillLayer(int y, const blockData &data) {
+            fillBox(glm::ivec3(0, y, 0), glm::ivec3((int)worldWidth - 1, y, (int)worldWidth - 1), data);
+        }
+
+        /**
+         * @brief Fills every cell between the two corners (inclusive) with the given block. Parts of
+         * the box outside of the world are ignored. See fillLayer
+         * 
+         * @param from 
+         * @param to 
+         * @param data 
+         */
+        void fillBox(glm::ivec3 from, glm::ivec3 to, const blockData &data) {
+            terrain.fillBox(from, to, data.id);
+            if (data.illuminating && data.id != chunk::AIR) {
+                pendingLights.emplace_back(from, to);
+            }
+        }
+
+        /**
+         * @brief Applies count edits from the given array in order. Edits outside of the world are
+         * skipped. See fillLayer
+         * 
+         * @param edits 
+         * @param count 
+         */
+        void applyEdits(const chunk::blockEdit_t *edits, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                const auto &edit = edits[i];
+                if (terrain.isOutOfBounds(edit.x, edit.y, edit.z)) continue;
+                terrain.setBlock(edit.x, edit.y, edit.z, edit.id);
+                if (blockRegistry[edit.id].illuminating) {
+                    pendingLights.emplace_back(glm::ivec3(edit.x, edit.y, edit.z), glm::ivec3(edit.x, edit.y, edit.z));
+                }
+            }
+        }
+
+        /**
+         * @brief Finishes a batch of bulk edits. Illuminating blocks which are still there get their
+         * light sources, until the renderer runs out of them, and edited chunks in view are remeshed
+         * 
+         * @param renderInfo 
+         */
+        void commitEdits(renderer::renderer_t *renderInfo) {
+            bool lightsFull = false;
+            for (const auto &box : pendingLights) {
+                auto from = glm::max(box.first, glm::ivec3(0));
+                auto to = glm::min(box.second, glm::ivec3(terrain.width - 1, terrain.height - 1, terrain.width - 1));
+                for (int y = from.y; y <= to.y && !lightsFull; y++) {
+                    for (int z = from.z; z <= to.z && !lightsFull; z++) {
+                        for (int x = from.x; x <= to.x && !lightsFull; x++) {
+                            const auto &data = getBlockType(x, y, z);
+                            // A later edit may have replaced the block
+                            auto instance = terrain.findInstance(x, y, z);
+                            if (!data.illuminating || (instance && instance->lightID >= 0)) continue;
+                            auto lightID = renderInfo->addLightSource(glm::vec3(x, y, z), data.rgb, data.intensity);
+                            lightsFull = lightID < 0;
+                            addBlockLight(x, y, z, lightID);
+                        }
+                    }
+                }
+            }
+            if (lightsFull) {
+                std::cout << "Maximum lights reached, can only have up to " << renderInfo->getMaxLights() << " point lights\n";
+            }
+            pendingLights.clear();
+            updateDirtyChunks();
+        }
+
         /**
          * @brief Finds a suitable respawn position of player and teleports them to there
          * If a block is in the way, the block will be deleted. If there aren't any blocks
@@ -1321,13 +1801,15 @@ namespace scene {
          * @param block 
          */
         void findRespawnPosition(renderer::renderer_t *renderInfo) {
-            playerCamera.pos = {round(terrain.size() / 2), 6.0f, round(terrain.at(0).at(0).size() / 2)};
+            playerCamera.pos = {round(worldWidth / 2), 6.0f, round(worldWidth / 2)};
             while (checkInsideBlock()) {
                 std::cout << "Some blocks were destroyed to make room for you to respawn in\n";
                 leftClickDestroy(renderInfo, playerCamera.pos);
-                leftClickDestroy(renderInfo, {round(terrain.size() / 2), 5.0f, round(terrain.at(0).at(0).size() / 2)});
+                leftClickDestroy(renderInfo, {round(worldWidth / 2), 5.0f, round(worldWidth / 2)});
             }
-            if (findClosestBlockAboveBelow(-1) < 0) {
+            // Ground which hasn't been paged in yet doesn't count as missing
+            bool loaded = terrain.isColumnLoaded((int)playerCamera.pos.x, (int)playerCamera.pos.z);
+            if (loaded && findClosestBlockAboveBelow(-1) < 0) {
                 std::cout << "No blocks below detected. Force flying mode enabled\n";
                 flyingMode = false;
                 toggleMode();
@@ -1343,8 +1825,8 @@ namespace scene {
          */
         void updatePlayerPositions(GLFWwindow *window, float dt, renderer::renderer_t *renderInfo) {
             swingHand(dt);
-            // camera angle update is reserved for player.cpp as that does not depend on the terrain
-            player::updateCameraAngle(playerCamera, window, dt);
+            // Chunks may have been paged in since the cursor was last found
+            cursor.valid = false;
 
             auto originalPosition = playerCamera.pos;
 
@@ -1368,7 +1850,7 @@ namespace scene {
             }
 
             // Slowing player down iif in water or on slime block
-            if (strcmp(blockBelowName().c_str(), "slime_block") == 0 && groundLevel == playerCamera.pos.y - 1.0f) {
+            if (blockRegistry[blockBelowID()].bouncy && groundLevel == playerCamera.pos.y - 1.0f) {
                 walkingMultiplier *= 0.5f;
             }
 
@@ -1388,54 +1870,26 @@ namespace scene {
             auto right = glm::vec3(trans[0]);
 
             if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-                playerCamera.pos.z += step * -glm::cos(glm::radians(playerCamera.yaw));
-                // Step backwards if player is sneaking and teetering off block, or they are inside a block
-                if (checkInsideBlock() || (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel)) {
-                    playerCamera.pos.z -= step * -glm::cos(glm::radians(playerCamera.yaw));
-                }
-                playerCamera.pos.x += step * glm::sin(glm::radians(playerCamera.yaw));
-                if (checkInsideBlock() || (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel)) {
-                    playerCamera.pos.x -= step * glm::sin(glm::radians(playerCamera.yaw));
-                }
+                movePlayer(2, step * -glm::cos(glm::radians(playerCamera.yaw)));
+                movePlayer(0, step * glm::sin(glm::radians(playerCamera.yaw)));
             }
             if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-                playerCamera.pos.z -= step * -glm::cos(glm::radians(playerCamera.yaw));
-                if (checkInsideBlock() || (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel)) {
-                    playerCamera.pos.z += step * -glm::cos(glm::radians(playerCamera.yaw));
-                }
-                playerCamera.pos.x -= step * glm::sin(glm::radians(playerCamera.yaw));
-                if (checkInsideBlock() || (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel)) {
-                    playerCamera.pos.x += step * glm::sin(glm::radians(playerCamera.yaw));
-                }
+                movePlayer(2, -step * -glm::cos(glm::radians(playerCamera.yaw)));
+                movePlayer(0, -step * glm::sin(glm::radians(playerCamera.yaw)));
             }
             if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
-                playerCamera.pos.z += right.z * -step;
-                if (checkInsideBlock() || (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel)) {
-                    playerCamera.pos.z -= right.z * -step;
-                }
-                playerCamera.pos.x += right.x * -step;
-                if (checkInsideBlock() || (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel)) {
-                    playerCamera.pos.x -= right.x * -step;
-                }
+                movePlayer(2, right.z * -step);
+                movePlayer(0, right.x * -step);
             }
             if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
-                playerCamera.pos.z += right.z * step;
-                if (checkInsideBlock() || (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel)) {
-                    playerCamera.pos.z -= right.z * step;
-                }
-                playerCamera.pos.x += right.x * step;
-                if (checkInsideBlock() || (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel)) {
-                    playerCamera.pos.x -= right.x * step;
-                }
+                movePlayer(2, right.z * step);
+                movePlayer(0, right.x * step);
             }
             if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && (playerCamera.yVelocity == 0 || flyingMode)) {
                 if (!flyingMode) {
                     playerCamera.yVelocity = JUMP_POWER;
                 } else {
-                    playerCamera.pos.y += step;
-                    if (checkInsideBlock()) {
-                        playerCamera.pos.y -= step;
-                    }
+                    sweepPlayer(1, step);
                 }
             } else if (glfwGetKey(window, GLFW_KEY_SPACE) && isUnderwater() && !flyingMode) {
                 // Controls swimming
@@ -1443,12 +1897,17 @@ namespace scene {
             }
             if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS && playerCamera.pos.y != (float)groundLevel + eyeLevel) {
                 if (flyingMode) {
-                    playerCamera.pos.y -= step;
+                    sweepPlayer(1, -step);
                     if (playerCamera.pos.y < (float)groundLevel + eyeLevel) {
                         playerCamera.pos.y = groundLevel + eyeLevel;
                     }
                 }
             }
+            // Chunks which haven't been paged in yet act like walls
+            if (!terrain.isColumnLoaded((int)round(playerCamera.pos.x), (int)round(playerCamera.pos.z))) {
+                playerCamera.pos.x = originalPosition.x;
+                playerCamera.pos.z = originalPosition.z;
+            }
             updateBlocksToRender();
             // If the positions differ, then bob the hand
             if (originalPosition.x != playerCamera.pos.x || playerCamera.pos.z != originalPosition.z) {
@@ -1488,10 +1947,24 @@ namespace scene {
                 // Spawn bubbles around player
                 particle::spawnFloatingParticles(&listOfParticles, playerCamera.pos, bubble, seaSurface.translation.y, 3);
             }
+            // The player hangs in the air until the chunks below them are paged in
+            bool columnLoaded = terrain.isColumnLoaded((int)round(playerCamera.pos.x), (int)round(playerCamera.pos.z));
+            if (!columnLoaded) {
+                playerCamera.yVelocity = 0.0f;
+            }
             // Enacting gravity onto the camera
-            if (!flyingMode) {
-
-                playerCamera.pos.y += playerCamera.yVelocity * dt;
+            if (!flyingMode && columnLoaded) {
+
+                // Falls or rises until the player's box runs into a block
+                auto fall = playerCamera.yVelocity * dt;
+                auto moved = sweepPlayer(1, fall);
+                bool landed = fall < 0.0f && moved > fall;
+                if (landed) {
+                    groundLevel = (int)round(playerCamera.pos.y - eyeLevel);
+                } else if (fall > 0.0f && moved < fall) {
+                    // Hit the ceiling, so start falling straight away
+                    playerCamera.yVelocity = 0.0f;
+                }
                 if (isUnderwater()) {
                     
                     playerCamera.yVelocity += GRAVITY * dt;
@@ -1502,7 +1975,7 @@ namespace scene {
                 auto terminalVelocity = isUnderwater() ? 2.0f : 40.0f;
                 playerCamera.yVelocity = glm::clamp(playerCamera.yVelocity, -terminalVelocity, terminalVelocity);
 
-                if (playerCamera.pos.y < (float)groundLevel + eyeLevel) {
+                if (landed || playerCamera.pos.y < (float)groundLevel + eyeLevel) {
                     // Prevents player from falling through the ground
 
                     if (abs(playerCamera.yVelocity) >= 7.0f) {
@@ -1511,7 +1984,7 @@ namespace scene {
 
                     playerCamera.pos.y = (float)groundLevel + eyeLevel;
                     // Controls the bounciness of the slime block
-                    if (strcmp(blockBelowName().c_str(), "slime_block") == 0) {
+                    if (blockRegistry[blockBelowID()].bouncy) {
                         playerCamera.yVelocity = abs(playerCamera.yVelocity) * 0.75f + GRAVITY * dt;
                         if (playerCamera.yVelocity >= 4.0f && !shiftMode) {
                             // Enacting gravity
@@ -1533,6 +2006,8 @@ namespace scene {
 
                 findRespawnPosition(renderInfo);
                 groundLevel = findClosestBlockAboveBelow(-1);
+                // Teleports aren't blended
+                previousPlayerPos = playerCamera.pos;
 
                 if (groundLevel > 0) {
                     playerCamera.pos.y = groundLevel;
@@ -1563,29 +2038,12 @@ namespace scene {
         }
 
         /**
-         * @brief Checks if the given x, y, z co-ordinates exists in the terrain/world
+         * @brief Gets the block type ID of the block below the player. Air if there isn't one
          * 
-         * @param x 
-         * @param y 
-         * @param z 
-         * @return true if out of bounds
-         * @return false if inside bounds
+         * @return uint8_t 
          */
-        bool isCoordOutBoundaries(int x, int y, int z) {
-            try {
-                terrain.at(x).at(y).at(z).air = terrain.at(x).at(y).at(z).air;
-            } catch (std::out_of_range) {
-                return true;
-            }
-            return false;
-        }
-
-        std::string blockBelowName() {
-            if (!isCoordOutBoundaries(round(playerCamera.pos.x), groundLevel - 1, round(playerCamera.pos.z))) {
-                return terrain.at(round(playerCamera.pos.x)).at(groundLevel - 1).at(round(playerCamera.pos.z)).name;
-            } else {
-                return "";
-            }
+        uint8_t blockBelowID() {
+            return terrain.blockOrAir((int)round(playerCamera.pos.x), groundLevel - 1, (int)round(playerCamera.pos.z));
         }
 
         /**
@@ -1596,17 +2054,14 @@ namespace scene {
         GLuint blockBelowTexID() {
             glm::vec3 blockPos = {round(playerCamera.pos.x), groundLevel - 1, round(playerCamera.pos.z)};
     
-            if (!isCoordOutBoundaries(blockPos.x, blockPos.y, blockPos.z)) {
-                if (terrain.at(blockPos.x).at(blockPos.y).at(blockPos.z).textureID != 0) {
-                    return terrain.at(blockPos.x).at(blockPos.y).at(blockPos.z).textureID;
-                }
+            if (getBlockType(blockPos.x, blockPos.y, blockPos.z).texture != 0) {
+                return getBlockType(blockPos.x, blockPos.y, blockPos.z).texture;
             }
             
             for (int x = -1; x <= 1; x++) {
                 for (int z = -1; z <= 1; z++) {
                     if (x == z) continue;
-                    if (isCoordOutBoundaries(blockPos.x + x, blockPos.y, blockPos.z + z)) continue;
-                    auto id = terrain.at(blockPos.x + x).at(blockPos.y).at(blockPos.z + z).textureID;
+                    auto id = getBlockType(blockPos.x + x, blockPos.y, blockPos.z + z).texture;
                     if (id != 0) {
                         return id;
                     }
@@ -1622,28 +2077,125 @@ namespace scene {
          * @return false if the player is not clipping into a block
          */
         bool checkInsideBlock() {
-            
-            float playerPosY = playerCamera.pos.y - eyeLevel;
-            float playerPosX = playerCamera.pos.x;
-            float playerPosZ = playerCamera.pos.z;
-
-            size_t xPosRd = (size_t)round(playerPosX);
-            size_t yPosRd = (size_t)round(playerPosY);
-            size_t zPosRd = (size_t)round(playerPosZ);
-
-            // Checks around the player in a circle if they are touching a block or not
-            for (float degree = 0; degree < 360.0f; degree += 5.0f) {
-                xPosRd = (size_t)round(playerPosX + PLAYER_RADIUS * (float)glm::sin(glm::radians(degree)));
-                zPosRd = (size_t)round(playerPosZ + PLAYER_RADIUS * (float)-glm::cos(glm::radians(degree)));
-                if (!isCoordOutBoundaries(xPosRd, yPosRd, zPosRd) && !terrain.at(xPosRd).at(yPosRd).at(zPosRd).air) {
-                    return true;
-                }
-                if (!isCoordOutBoundaries(xPosRd, yPosRd + 1, zPosRd) && !terrain.at(xPosRd).at(yPosRd + 1).at(zPosRd).air) {
-                    return true;
+            glm::vec3 low, high;
+            getPlayerBox(playerCamera.pos, low, high);
+            auto xCells = coveredCells(low.x, high.x);
+            auto yCells = coveredCells(low.y, high.y);
+            auto zCells = coveredCells(low.z, high.z);
+            for (int y = yCells.x; y <= yCells.y; y++) {
+                for (int z = zCells.x; z <= zCells.y; z++) {
+                    for (int x = xCells.x; x <= xCells.y; x++) {
+                        if (terrain.isSolid(x, y, z)) {
+                            return true;
+                        }
+                    }
                 }
             }
             return false;
-            
+        }
+
+        /**
+         * @brief Finds the box the player takes up when standing at the given camera position. It is
+         * PLAYER_RADIUS wide either side and runs from the bottom of the block the feet are in to two
+         * blocks above it
+         * 
+         * @param pos 
+         * @param low 
+         * @param high 
+         */
+        void getPlayerBox(glm::vec3 pos, glm::vec3 &low, glm::vec3 &high) {
+            low = pos + playerBoxLow();
+            high = pos + playerBoxHigh();
+        }
+
+        glm::vec3 playerBoxLow() {
+            return glm::vec3(-PLAYER_RADIUS, -eyeLevel - 0.5f, -PLAYER_RADIUS);
+        }
+
+        glm::vec3 playerBoxHigh() {
+            return glm::vec3(PLAYER_RADIUS, 1.5f - eyeLevel, PLAYER_RADIUS);
+        }
+
+        /**
+         * @brief Finds the first and last block along one axis that the span from low to high overlaps.
+         * Blocks are centred on whole numbers, and a span which only touches a block's face doesn't
+         * overlap it
+         * 
+         * @param low 
+         * @param high 
+         * @return glm::ivec2 
+         */
+        static glm::ivec2 coveredCells(float low, float high) {
+            return glm::ivec2((int)floor(low + 0.5f + COLLISION_EPSILON), (int)floor(high + 0.5f - COLLISION_EPSILON));
+        }
+
+        /**
+         * @brief Moves the player along one axis (0 for x, 1 for y, 2 for z), stopping them flush
+         * against the first solid block in the way. Only the layers of blocks the player's box sweeps
+         * into are looked at, and only over the blocks the box overlaps on the other two axes
+         * 
+         * @param axis 
+         * @param delta 
+         * @return float distance actually moved
+         */
+        float sweepPlayer(int axis, float delta) {
+            if (delta == 0.0f) return 0.0f;
+            glm::vec3 low, high;
+            getPlayerBox(playerCamera.pos, low, high);
+
+            int axisA = (axis + 1) % 3, axisB = (axis + 2) % 3;
+            auto cellsA = coveredCells(low[axisA], high[axisA]);
+            auto cellsB = coveredCells(low[axisB], high[axisB]);
+            auto layerIsSolid = [&](int layer) {
+                glm::ivec3 cell;
+                cell[axis] = layer;
+                for (cell[axisA] = cellsA.x; cell[axisA] <= cellsA.y; cell[axisA]++) {
+                    for (cell[axisB] = cellsB.x; cell[axisB] <= cellsB.y; cell[axisB]++) {
+                        if (terrain.isSolid(cell.x, cell.y, cell.z)) return true;
+                    }
+                }
+                return false;
+            };
+
+            auto start = playerCamera.pos[axis];
+            if (delta > 0.0f) {
+                // Layers between the leading face now and where it would end up
+                int first = (int)floor(high[axis] + 0.5f - COLLISION_EPSILON) + 1;
+                int last = (int)floor(high[axis] + delta + 0.5f - COLLISION_EPSILON);
+                playerCamera.pos[axis] += delta;
+                for (int layer = first; layer <= last; layer++) {
+                    if (layerIsSolid(layer)) {
+                        playerCamera.pos[axis] = std::max(start, (float)layer - 0.5f - playerBoxHigh()[axis]);
+                        break;
+                    }
+                }
+            } else {
+                int first = (int)floor(low[axis] + 0.5f + COLLISION_EPSILON) - 1;
+                int last = (int)floor(low[axis] + delta + 0.5f + COLLISION_EPSILON);
+                playerCamera.pos[axis] += delta;
+                for (int layer = first; layer >= last; layer--) {
+                    if (layerIsSolid(layer)) {
+                        playerCamera.pos[axis] = std::min(start, (float)layer + 0.5f - playerBoxLow()[axis]);
+                        break;
+                    }
+                }
+            }
+            return playerCamera.pos[axis] - start;
+        }
+
+        /**
+         * @brief Walks the player along the x or z axis. A sneaking player on the ground is stopped
+         * before they step off the edge of a block
+         * 
+         * @param axis 
+         * @param delta 
+         */
+        void movePlayer(int axis, float delta) {
+            auto before = playerCamera.pos;
+            sweepPlayer(axis, delta);
+            if (playerCamera.yVelocity == 0.0f && shiftMode && findClosestBlockAboveBelow(-1) < playerCamera.pos.y - eyeLevel) {
+                playerCamera.pos = before;
+            }
         }
         
         /**
@@ -1665,33 +2217,27 @@ namespace scene {
             }
             
 
-            int maxInt = (direction < 0) ? 1 : WORLD_HEIGHT;
-
-            for (int i = (int)posY; i * direction < maxInt; i += direction) {
-                int xPosRd = (int)round(posX);
-                int yPosRd = (int)round(i);
-                int zPosRd = (int)round(posZ);
-
-                // Checks around the player in a circle if they are touching a block or not
-                for (float degree = 0; degree < 360.0f; degree += 5.0f) {
-                    xPosRd = (int)round(posX + PLAYER_RADIUS * (float)glm::sin(glm::radians(degree)));
-                    zPosRd = (int)round(posZ + PLAYER_RADIUS * (float)-glm::cos(glm::radians(degree)));
-                    if (isCoordOutBoundaries(xPosRd, yPosRd, zPosRd)) {
-                        continue;
-                    }
-                    if (!terrain.at(xPosRd).at(yPosRd).at(zPosRd).air) {
-                        // Correcting
-                        if (direction < 0) {
-                            return yPosRd - direction;
-                        } else {
-                            return yPosRd;
-                        }
-                        
+            // Columns under the player's box, at most four of them. Each column's heightmap gives
+            // its closest block straight away
+            auto xCells = coveredCells(posX - PLAYER_RADIUS, posX + PLAYER_RADIUS);
+            auto zCells = coveredCells(posZ - PLAYER_RADIUS, posZ + PLAYER_RADIUS);
+            int start = (int)posY, closest = -1;
+            for (int z = zCells.x; z <= zCells.y; z++) {
+                for (int x = xCells.x; x <= xCells.y; x++) {
+                    if (direction < 0) {
+                        auto below = terrain.solidBelow(x, start, z);
+                        closest = std::max(closest, below);
+                    } else {
+                        auto above = terrain.solidAbove(x, std::max(start, 0), z);
+                        if (above >= 0 && (closest < 0 || above < closest)) closest = above;
                     }
                 }
-                
             }
-            
+            if (closest >= 0) {
+                // Correcting
+                return direction < 0 ? closest - direction : closest;
+            }
+
             return (int)direction * (int)WORLD_HEIGHT * (int)WORLD_HEIGHT;
         }
 
@@ -1717,48 +2263,52 @@ namespace scene {
         }
 
         /**
-         * @brief Draws all the particles inside listOfParticles. Does not draw anything if the shader given is not a particle render
+         * @brief Draws all the particles inside listOfParticles, alpha of the way through the last tick.
+         * The shader given must be the particle render
          * 
          * @param particleRender 
          * @param proj 
-         * @param dt 
-         * @param animate 
+         * @param alpha 
          */
-        void drawParticles(renderer::renderer_t particleRender, glm::mat4 proj, float dt, bool animate = true) {
-            if (strcmp(particleRender.type.c_str(), "particle") != 0) return;
-            particle::drawAllParticles(&listOfParticles, particleRender, getCurrCamera()->get_view(), proj, GRAVITY, dt, animate);
+        void drawParticles(const renderer::renderer_t &particleRender, glm::mat4 proj, float alpha) {
+            particle::drawAllParticles(&listOfParticles, particleRender, getCurrCamera()->get_view(), proj, alpha);
         }
 
         /**
          * @brief Draws the terrain, HUD, lighting effects etc.
          * 
+         * @tparam Pass 
          * @param renderInfo 
          */
-        void drawWorld(renderer::renderer_t renderInfo, bool onlyIlluminating = false, bool drawHand = false) {
+        template <renderer::pass_t Pass>
+        void drawWorld(const renderer::renderer_t &renderInfo, bool drawHand = false) {
 
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            if (strcmp(renderInfo.type.c_str(), "default") == 0) {
-                renderInfo.setBasePters(getCurrCamera()->pos);
+            if constexpr (renderer::isTextured(Pass)) {
                 if (drawCelestials) {
                     glDepthRange(0.999,1);
-                    drawElement(&centreOfWorld, glm::mat4(1.0f), renderInfo);
+                    drawElement<Pass>(&centreOfWorld, glm::mat4(1.0f), renderInfo);
                     glDepthRange(0,1);
                 }
             }
-            drawTerrain(glm::mat4(1.0f), renderInfo, onlyIlluminating, getCurrCamera());
+            drawTerrain<Pass>(glm::mat4(1.0f), renderInfo, getCurrCamera());
 
             // Draw the player if we are rendering shadow
-            if (strcmp(renderInfo.type.c_str(), "shadow") == 0 && !cutsceneEnabled) {
-                player.moveBody(playerCamera.pos, shiftMode, worldTime);
-                drawElement(&player.positionInWorld, glm::mat4(1.0f), renderInfo);
+            if constexpr (Pass == renderer::pass_t::shadow) {
+                if (!cutsceneEnabled) {
+                    player.moveBody(playerCamera.pos, shiftMode, worldTime);
+                    drawElement<Pass>(&player.positionInWorld, glm::mat4(1.0f), renderInfo);
+                }
             }
 
             // Draw bed if cutscene is occuring
-            if (cutsceneEnabled && onlyIlluminating) {
-                renderInfo.setInt("forceBlack", true);
-                drawElement(&bed, glm::mat4(1.0f), renderInfo);
-                renderInfo.setInt("forceBlack", false);
+            if constexpr (Pass == renderer::pass_t::bloom) {
+                if (cutsceneEnabled) {
+                    renderInfo.setInt("forceBlack", true);
+                    drawElement<Pass>(&bed, glm::mat4(1.0f), renderInfo);
+                    renderInfo.setInt("forceBlack", false);
+                }
             }
 
             //drawElement(&seaSurface, glm::mat4(1.0f), renderInfo);
@@ -1770,7 +2320,7 @@ namespace scene {
          * 
          * @param renderInfo 
          */
-        void drawHand(renderer::renderer_t renderInfo) {
+        void drawHand(const renderer::renderer_t &renderInfo) {
             // Drawing the 3D hand on screen
             renderInfo.setInt("affectedByShadows", false);
             screenHand.translation.x = playerCamera.pos.x;
@@ -1784,7 +2334,7 @@ namespace scene {
                 screenHand.rotation.y += 360.0f;
             }
             screenHand.rotation.y = utility::lerp(screenHand.rotation.y, -playerCamera.yaw, 0.65f);
-            drawElement(&screenHand, glm::mat4(1.0f), renderInfo);
+            drawElement<renderer::pass_t::color>(&screenHand, glm::mat4(1.0f), renderInfo);
             renderInfo.setInt("affectedByShadows", true);
         }
 
@@ -1794,16 +2344,17 @@ namespace scene {
          * @return glm::vec3 
          */
         glm::vec3 getCentreOfWorld() {
-            return {terrain.size() / 2, 0, terrain.at(0).at(0).size() / 2};
+            return {worldWidth / 2, 0, worldWidth / 2};
         }
 
         /**
-         * @brief Get how big the generated world is
+         * @brief Get how big the generated world is. Unbounded worlds give the width of the area
+         * kept loaded around the player
          * 
          * @return float 
          */
         float getWorldSize() {
-            return terrain.size();
+            return unbounded ? (float)(2 * pageRadius() * chunk::CHUNK_SIZE) : (float)worldWidth;
         }
 
         /**
@@ -1811,72 +2362,118 @@ namespace scene {
          * Also calculates the degree between the block and the players looking vector to determine
          * if the block is within the players view point
          * 
+         * @tparam Pass 
          * @param parent_mvp 
          * @param renderInfo 
+         * @param cam 
          */
-        void drawTerrain(const glm::mat4 &parent_mvp, renderer::renderer_t renderInfo, bool onlyIlluminating, player::playerPOV *cam, bool ignoreFrustum = false) {
+        template <renderer::pass_t Pass>
+        void drawTerrain(const glm::mat4 &parent_mvp, const renderer::renderer_t &renderInfo, player::playerPOV *cam) {
 
-            for (size_t i = 0; i < listOfBlocksToRender.size(); i++) {
-                float x = listOfBlocksToRender[i]->translation.x;
-                float y = listOfBlocksToRender[i]->translation.y;
-                float z = listOfBlocksToRender[i]->translation.z;
-                
-                if (utility::calculateDistance(glm::vec3(x, y, z), cam->pos) <= renderDistance) {
-                    
-                    if (!(strcmp(renderInfo.type.c_str(), "shadow") == 0 && listOfBlocksToRender[i]->transparent)) {
-                        
-                        if (strcmp(renderInfo.type.c_str(), "shadow") == 0) {
-                            drawBlock(listOfBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        } else if (ignoreFrustum || frustum::isBlockInView(player::getLookingDirection(cam, 1), glm::vec3(x, y, z), cam->pos)) {
-                            drawBlock(listOfBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        } else if (utility::calculateDistance(glm::vec3(x, y, z), cam->pos) <= 2.0f) {
-                            drawBlock(listOfBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        }
+            bindBlockTextures<Pass>();
+            for (auto chunkMesh : chunksToRender) {
+                if (utility::calculateDistance(chunkMesh->centre, cam->pos) > (float)renderDistance + mesher::CHUNK_RADIUS) continue;
+
+                if (!isCulledPass(Pass) || isChunkInView(*chunkMesh, cam)) {
+                    drawChunk<Pass>(chunkMesh, parent_mvp, renderInfo);
+                }
+            }
+            drawBlocks<Pass>(listOfBlocksToRender, parent_mvp, renderInfo, cam);
+        }
+
+        /**
+         * @brief Checks if the given pass is drawn from the camera, so anything out of its view can
+         * be skipped
+         * 
+         * @param pass 
+         * @return true 
+         * @return false 
+         */
+        static constexpr bool isCulledPass(renderer::pass_t pass) {
+            return pass != renderer::pass_t::shadow && pass != renderer::pass_t::cubemap;
+        }
+
+        /**
+         * @brief Draws the given blocks which are within render distance with instanced calls.
+         * Shadow passes skip transparent blocks and cast shadows from every face
+         * 
+         * @tparam Pass 
+         * @param blocks 
+         * @param parent_mvp 
+         * @param renderInfo 
+         * @param cam 
+         */
+        template <renderer::pass_t Pass>
+        void drawBlocks(const std::vector<node_t> &blocks, const glm::mat4 &parent_mvp, const renderer::renderer_t &renderInfo, player::playerPOV *cam) {
+            auto lookingDirection = player::getLookingDirection(cam, 1);
+            blockInstances.instances.clear();
+            for (const auto &block : blocks) {
+                if (utility::calculateDistance(block.translation, cam->pos) > renderDistance) continue;
+                if constexpr (Pass == renderer::pass_t::shadow) {
+                    if (block.transparent) continue;
+                }
+
+                if (!isCulledPass(Pass) || frustum::isBlockInView(lookingDirection, block.translation, cam->pos) || utility::calculateDistance(block.translation, cam->pos) <= 2.0f) {
+                    // Faces hidden from the camera can still cast shadows
+                    auto faces = block.visibleFaces;
+                    if constexpr (Pass == renderer::pass_t::shadow) {
+                        faces = chunk::ALL_FACES;
                     }
+                    instancer::add(blockInstances, block.translation, block.rotation, faces, block.blockID, block.illuminating);
                 }
             }
+            instancer::upload(blockInstances);
+            bindBlockTextures<Pass>();
+            drawInstances<Pass>(&blockInstances, parent_mvp, renderInfo);
+        }
+
+        /**
+         * @brief Checks if any part of the given chunk is within the camera's view
+         * 
+         * @param chunkMesh 
+         * @param cam 
+         * @return true if the chunk should be drawn
+         * @return false if the chunk is completely out of view
+         */
+        bool isChunkInView(const mesher::chunkMesh_t &chunkMesh, player::playerPOV *cam) {
+            if (utility::calculateDistance(chunkMesh.centre, cam->pos) <= mesher::CHUNK_RADIUS) return true;
+
+            auto lookingDirection = player::getLookingDirection(cam, 1);
+            if (frustum::isBlockInView(lookingDirection, chunkMesh.centre, cam->pos)) return true;
+            // Testing every corner of the chunk
+            for (int corner = 0; corner < 8; corner++) {
+                auto offset = glm::vec3((corner & 1) ? 1 : -1, (corner & 2) ? 1 : -1, (corner & 4) ? 1 : -1) * ((float)chunk::CHUNK_SIZE / 2.0f);
+                if (frustum::isBlockInView(lookingDirection, chunkMesh.centre + offset, cam->pos)) return true;
+            }
+            return false;
         }
 
         /**
          * @brief Draws all the transparent bocks
          * 
+         * @tparam Pass 
          * @param parent_mvp 
          * @param renderInfo 
-         * @param onlyIlluminating 
          */
-        void drawTransTerrain(const glm::mat4 &parent_mvp, renderer::renderer_t renderInfo, bool onlyIlluminating) {
+        template <renderer::pass_t Pass>
+        void drawTransTerrain(const glm::mat4 &parent_mvp, const renderer::renderer_t &renderInfo) {
 
             // Draw bed if cutscene is occuring
             if (cutsceneEnabled) {
-                drawElement(&bed, glm::mat4(1.0f), renderInfo);
+                drawElement<Pass>(&bed, glm::mat4(1.0f), renderInfo);
             }
 
-            for (size_t i = 0; i < listOfTransBlocksToRender.size(); i++) {
-                float x = listOfTransBlocksToRender[i]->translation.x;
-                float y = listOfTransBlocksToRender[i]->translation.y;
-                float z = listOfTransBlocksToRender[i]->translation.z;
-                
-                if (utility::calculateDistance(glm::vec3(x, y, z), getCurrCamera()->pos) <= renderDistance) {
-                    
-                    if (!(strcmp(renderInfo.type.c_str(), "shadow") == 0 && listOfBlocksToRender[i]->transparent)) {
-
-                        if (strcmp(renderInfo.type.c_str(), "shadow") == 0) {
-                            drawBlock(listOfTransBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        } else if (frustum::isBlockInView(player::getLookingDirection(getCurrCamera(), 1), glm::vec3(x, y, z), getCurrCamera()->pos)) {
-                            drawBlock(listOfTransBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        } else if (utility::calculateDistance(glm::vec3(x, y, z), getCurrCamera()->pos) <= 2.0f) {
-                            drawBlock(listOfTransBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        }
-                    }
-                }
-            }
+            drawBlocks<Pass>(listOfTransBlocksToRender, parent_mvp, renderInfo, getCurrCamera());
+
             // Drawing highlight around selected block as that is transparent as well
-            if (!shiftMode && strcmp(renderInfo.type.c_str(), "default") == 0) {
-                // Drawing the highlighted block if shift mode is not enabled
-                highlightedBlock.translation = findCursorBlock(false);
-                auto pos = highlightedBlock.translation;
-                if (!isCoordOutBoundaries(pos.x, pos.y, pos.z)) {
-                    drawElement(&highlightedBlock, glm::mat4(1.0f), renderInfo);
+            if constexpr (Pass == renderer::pass_t::color) {
+                if (!shiftMode) {
+                    // Drawing the highlighted block if shift mode is not enabled
+                    highlightedBlock.translation = findCursorBlock(false);
+                    auto pos = highlightedBlock.translation;
+                    if (!terrain.isOutOfBounds(pos.x, pos.y, pos.z)) {
+                        drawElement<Pass>(&highlightedBlock, glm::mat4(1.0f), renderInfo);
+                    }
                 }
             }
         }
@@ -1884,31 +2481,13 @@ namespace scene {
         /**
          * @brief Draws shiny terrain aas if it was a solid block
          * 
+         * @tparam Pass 
          * @param parent_mvp 
          * @param renderInfo 
-         * @param onlyIlluminating 
          */
-        void drawShinyTerrainNormally(const glm::mat4 &parent_mvp, renderer::renderer_t renderInfo, bool onlyIlluminating) {
-
-            for (size_t i = 0; i < listOfShinyBlocksToRender.size(); i++) {
-                float x = listOfShinyBlocksToRender[i]->translation.x;
-                float y = listOfShinyBlocksToRender[i]->translation.y;
-                float z = listOfShinyBlocksToRender[i]->translation.z;
-                
-                if (utility::calculateDistance(glm::vec3(x, y, z), getCurrCamera()->pos) <= renderDistance) {
-                    
-                    if (!(strcmp(renderInfo.type.c_str(), "shadow") == 0 && listOfBlocksToRender[i]->transparent)) {
-
-                        if (strcmp(renderInfo.type.c_str(), "shadow") == 0) {
-                            drawBlock(listOfShinyBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        } else if (frustum::isBlockInView(player::getLookingDirection(getCurrCamera(), 1), glm::vec3(x, y, z), getCurrCamera()->pos)) {
-                            drawBlock(listOfShinyBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        } else if (utility::calculateDistance(glm::vec3(x, y, z), getCurrCamera()->pos) <= 2.0f) {
-                            drawBlock(listOfShinyBlocksToRender[i], parent_mvp, renderInfo, onlyIlluminating);
-                        }
-                    }
-                }
-            }
+        template <renderer::pass_t Pass>
+        void drawShinyTerrainNormally(const glm::mat4 &parent_mvp, const renderer::renderer_t &renderInfo) {
+            drawBlocks<Pass>(listOfShinyBlocksToRender, parent_mvp, renderInfo, getCurrCamera());
         }
 
         /**
@@ -1918,17 +2497,20 @@ namespace scene {
          * @param skyColor 
          * @param winSize 
          */
-        void updateShinyTerrain(renderer::renderer_t defaultRender, glm::vec3 skyColor,glm::vec2 winSize) {
+        void updateShinyTerrain(renderer::renderer_t &defaultRender, glm::vec3 skyColor,glm::vec2 winSize) {
             for (size_t i = 0; i < listOfShinyBlocksToRender.size(); i++) {
 
-                if (listOfShinyBlocksToRender.at(i)->reflectionTexID != 0) {
+                if (listOfShinyBlocksToRender.at(i).reflectionTexID != 0) {
                     // Delete the current texture if there was any
-                    texture_2d::destroy(listOfShinyBlocksToRender.at(i)->reflectionTexID);
+                    texture_2d::destroy(listOfShinyBlocksToRender.at(i).reflectionTexID);
                 }
-                listOfShinyBlocksToRender.at(i)->reflectionTexID = texture_2d::createEmptyCubeMap(REFLECTION_SIZE);
+                auto &shinyBlock = listOfShinyBlocksToRender.at(i);
+                shinyBlock.reflectionTexID = texture_2d::createEmptyCubeMap(REFLECTION_SIZE);
+                // Keeping the terrain in sync so the cubemap survives the render list being rebuilt
+                terrain.getInstance(shinyBlock.x, shinyBlock.y, shinyBlock.z).reflectionTexID = shinyBlock.reflectionTexID;
                 renderToEnvironmentMap(
-                    listOfShinyBlocksToRender.at(i)->reflectionTexID,
-                    listOfShinyBlocksToRender.at(i)->translation,
+                    listOfShinyBlocksToRender.at(i).reflectionTexID,
+                    listOfShinyBlocksToRender.at(i).translation,
                     defaultRender,
                     skyColor,
                     winSize
@@ -1940,43 +2522,43 @@ namespace scene {
         /**
          * @brief Draws shiny terrain with the mirror greenscreen texture and reflecting its cubemap
          * 
-         * @param viewProj 
          * @param renderInfo 
          * @param forceMap 
          */
-        void drawShinyTerrain(const glm::mat4 &viewProj, renderer::renderer_t renderInfo, GLuint forceMap = 0) {
-            for (size_t i = 0; i < listOfShinyBlocksToRender.size(); i++) {
-                
-                renderInfo.activate();
-
-                // Drawing the reflection
-                auto model = glm::mat4(1.0f);
-                model *= glm::translate(glm::mat4(1.0), listOfShinyBlocksToRender[i]->translation);
-                model *= glm::scale(glm::mat4(1.0), listOfShinyBlocksToRender[i]->scale);
-                model *= glm::rotate(glm::mat4(1.0), glm::radians(listOfShinyBlocksToRender[i]->rotation.z), glm::vec3(0, 0, 1));
-                model *= glm::rotate(glm::mat4(1.0), glm::radians(listOfShinyBlocksToRender[i]->rotation.y), glm::vec3(0, 1, 0));
-                model *= glm::rotate(glm::mat4(1.0), glm::radians(listOfShinyBlocksToRender[i]->rotation.x), glm::vec3(1, 0, 0));
-
-                // Rendering the shiny bits
-                renderInfo.setMat4("uViewProjReflection", viewProj);
-                renderInfo.setMat4("uModel", model);
-                renderInfo.setInt("environmentMap", 0);
-                renderInfo.setInt("uTex", 1);
-                renderInfo.setVec3("cameraPos", getCurrCamera()->pos);
-                glActiveTexture(GL_TEXTURE0);
-                if (forceMap != 0) {
-                    glBindTexture(GL_TEXTURE_CUBE_MAP, forceMap);
-                } else {
-                    glBindTexture(GL_TEXTURE_CUBE_MAP, listOfShinyBlocksToRender.at(i)->reflectionTexID);
+        void drawShinyTerrain(const renderer::renderer_t &renderInfo, GLuint forceMap = 0) {
+            if (listOfShinyBlocksToRender.empty()) return;
+
+            // Kept in the order of the list so each instance lines up with its own cube map
+            blockInstances.instances.clear();
+            for (const auto &block : listOfShinyBlocksToRender) {
+                instancer::add(blockInstances, block.translation, block.rotation, block.visibleFaces, block.blockID, false);
+            }
+            instancer::upload(blockInstances);
+
+            renderInfo.activate();
+            renderInfo.setMat4("uModel", glm::mat4(1.0f));
+            renderInfo.setInt("environmentMap", 0);
+            renderInfo.setInt("uTex", 1);
+            renderInfo.setInt("instanced", true);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, mirrorGreenscreen);
+            glActiveTexture(GL_TEXTURE0);
+            glBindVertexArray(blockInstances.cube.vao);
+
+            if (forceMap != 0) {
+                // Every mirror shows the same map so they all go in one call
+                glBindTexture(GL_TEXTURE_CUBE_MAP, forceMap);
+                instancer::bindInstances(blockInstances, 0);
+                glDrawElementsInstanced(GL_TRIANGLES, blockInstances.cube.indices_count, GL_UNSIGNED_INT, nullptr, (GLsizei)blockInstances.instances.size());
+            } else {
+                for (size_t i = 0; i < listOfShinyBlocksToRender.size(); i++) {
+                    glBindTexture(GL_TEXTURE_CUBE_MAP, listOfShinyBlocksToRender[i].reflectionTexID);
+                    instancer::bindInstances(blockInstances, (GLint)i);
+                    glDrawElementsInstanced(GL_TRIANGLES, blockInstances.cube.indices_count, GL_UNSIGNED_INT, nullptr, 1);
                 }
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, mirrorGreenscreen);
-                listOfShinyBlocksToRender.at(i)->ignoreCulling = true;
-                
-                glBindVertexArray(listOfShinyBlocksToRender[i]->mesh.vao);
-                glDrawElements(GL_TRIANGLES, listOfShinyBlocksToRender[i]->mesh.indices_count, GL_UNSIGNED_INT, nullptr);
-                glBindVertexArray(0);
             }
+            glBindVertexArray(0);
+            renderInfo.setInt("instanced", false);
         }
 
         /**
@@ -1991,7 +2573,7 @@ namespace scene {
         void renderToEnvironmentMap (
             GLuint cubeMap,
             glm::vec3 centre,
-            renderer::renderer_t basicShader,
+            renderer::renderer_t &basicShader,
             glm::vec3 skyColor,
             glm::vec2 winSize
         ) {
@@ -2057,9 +2639,9 @@ namespace scene {
 
                 glClearColor(skyColor.r, skyColor.g, skyColor.b, 1);
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-                basicShader.setMat4("uViewProj", projViewMatrix);
+                basicShader.setCamera(projViewMatrix, cubemapCamera.pos);
 
-                drawTerrain(glm::mat4(1.0f), basicShader, false, &cubemapCamera, true);
+                drawTerrain<renderer::pass_t::cubemap>(glm::mat4(1.0f), basicShader, &cubemapCamera);
                 
             }
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -2078,7 +2660,7 @@ namespace scene {
          * @param currTex 
          * @param blendValue 
          */
-        void drawSkyBox(renderer::renderer_t shader, glm::mat4 proj, GLuint prevTex, GLuint currTex, GLfloat blendValue) {
+        void drawSkyBox(const renderer::renderer_t &shader, glm::mat4 proj, GLuint prevTex, GLuint currTex, GLfloat blendValue) {
             glDepthFunc(GL_LEQUAL);
             shader.activate();
             auto skyBoxView = glm::mat4(glm::mat3(getCurrCamera()->get_view()));
@@ -2103,9 +2685,26 @@ namespace scene {
          * a certain criteria
          */
         void spawnBlockParticles() {
-            for (auto block : listOfBlocksToRender) {
-                auto pos = block->translation;
-                if (strcmp(block->name.c_str(), "magma") == 0) {
+            for (auto chunkMesh : chunksToRender) {
+                for (auto cell : chunkMesh->surfaceCells) {
+                    auto pos = chunkMesh->origin + chunk::localPosition(cell);
+                    spawnParticlesAround(terrain.blockOrAir(pos.x, pos.y, pos.z), glm::vec3(pos));
+                }
+            }
+            for (auto &block : listOfBlocksToRender) {
+                spawnParticlesAround(block.blockID, block.translation);
+            }
+        }
+
+        /**
+         * @brief Randomly spawns the particles belonging to the given block type at the given position
+         * 
+         * @param blockID 
+         * @param pos 
+         */
+        void spawnParticlesAround(uint8_t blockID, glm::vec3 pos) {
+            switch (blockRegistry[blockID].emitter) {
+                case blocks::SMOKE_EMITTER:
                     // Spawns either bubbles or smoke depending on if it's underwater or not
                     if (rand() % 15 == 0) {
                         if (isUnderwater(pos)) {
@@ -2114,132 +2713,342 @@ namespace scene {
                             particle::spawnSlowFloatingParticles(&listOfParticles, pos, smokeParticles[rand() % TOTAL_SMOKE], findClosestBlockAboveBelow(1, glm::vec3(pos.x, pos.y + 1, pos.z)) - 0.5f);
                         }
                     }
-                } else if (strcmp(block->name.c_str(), "crying_obsidian") == 0) {
+                    break;
+                case blocks::TEAR_EMITTER:
                     // Spawning purple obsidian tears
                     if (!isUnderwater(pos) && rand() % 30 == 0) {
                         particle::spawnDripParticles(&listOfParticles, pos, tear, findClosestBlockAboveBelow(-1, glm::vec3(pos.x, pos.y - 1, pos.z)) - 0.5f);
                     }
-                } else if (strcmp(block->name.c_str(), "redstone_ore") == 0) {
+                    break;
+                case blocks::DUST_EMITTER:
                     // Spawning red dust around redstone
                     if (rand() % 30 == 0) {
                         particle::spawnBlockAmbientParticle(&listOfParticles, pos, dust[rand() % TOTAL_DUST], glm::vec3(255.0f, 0.0f, 0.0f) / 255.0f);
                     }
-                } else if (strcmp(block->name.c_str(), "marccoin_block") == 0) {
+                    break;
+                case blocks::GLINT_EMITTER:
                     // Spawning glitter
                     if (rand() % 30 == 0) {
                         particle::spawnBlockAmbientParticle(&listOfParticles, pos, glint, glm::vec3(255.0f, 215.0f, 0.0f) / 255.0f);
                     }
-                } else if (block->name.rfind("coral", 0) == 0) {
+                    break;
+                case blocks::FISH_EMITTER:
                     // Spawning fish around coral
                     if (isUnderwater(pos)) {
                         if (rand() % 100 == 0) particle::spawnParticleAround(&listOfParticles, pos, fish[rand() % TOTAL_FISH], seaSurface.translation.y);
                         if (rand() % 100 == 0) particle::spawnParticleAround(&listOfParticles, pos, fish[rand() % TOTAL_FISH], seaSurface.translation.y);
                         if (rand() % 100 == 0) particle::spawnParticleAround(&listOfParticles, pos, fish[rand() % TOTAL_FISH], seaSurface.translation.y);
                     }
-                } else if (utility::isInRange(worldTime, 0.65f, 0.9f) && rand() % 1000 == 0 && rand() % 10 == 0 && !isUnderwater(pos)) {
-                    // Spawning fire flies during the night around blocks
-                    particle::spawnAmbientParticle(&listOfParticles, pos, firefly[rand() % TOTAL_FIREFLY], seaSurface.translation.y);
-                }
+                    break;
+                case blocks::NO_EMITTER:
+                    if (utility::isInRange(worldTime, 0.65f, 0.9f) && rand() % 1000 == 0 && rand() % 10 == 0 && !isUnderwater(pos)) {
+                        // Spawning fire flies during the night around blocks
+                        particle::spawnAmbientParticle(&listOfParticles, pos, firefly[rand() % TOTAL_FIREFLY], seaSurface.translation.y);
+                    }
+                    break;
             }
         }
 
+        /**
+         * @brief Prints how many vertices the currently built chunk meshes hold and how much
+         * GPU memory they take up
+         * 
+         */
+        void printChunkMeshUsage() {
+            size_t totalVertices = 0, totalIndices = 0;
+            for (const auto &entry : chunkMeshes) {
+                totalVertices += entry.second.totalVertices;
+                totalIndices += (size_t)entry.second.mesh.indices_count;
+            }
+            auto bytes = totalVertices * sizeof(mesher::packedVertex_t) + totalIndices * sizeof(GLushort);
+            std::cout << "Chunk meshes use " << totalVertices << " vertices (" << bytes / 1024 << "KB)" << (greedyMeshing ? " with greedy meshing\n" : "\n");
+        }
 
         /**
-         * @brief Call this to update the listOfBlocks to render. Only works if the last rendered position is far away enough from
-         * the player's current position. forceRender = true to ignore this
+         * @brief Remeshes the given chunk if it is dirty, then adds its mesh and the blocks which
+         * aren't baked into it to the render lists
          * 
-         * @param forceRender 
+         * @param index 
+         * @param section 
          */
-        void updateBlocksToRender(bool forceRender = false) {
+        void addChunkToRender(size_t index, chunk::chunk_t &section) {
+            // Chunks that have never held a block don't need a mesh at all
+            if (section.totalSolid == 0 && !chunkMeshes.count(index)) {
+                section.dirty = false;
+                return;
+            }
+            auto chunkPos = terrain.chunkPosition(index);
+            auto &chunkMesh = chunkMeshes[index];
+            // Only remeshing chunks that have been changed
+            if (section.dirty) {
+                mesher::buildChunkMesh(chunkMesh, terrain, blockRegistry, chunkPos.x, chunkPos.y, chunkPos.z, greedyMeshing);
+                section.dirty = false;
+            } else if (chunkMesh.needsUpload) {
+                // Meshed while the world was being generated
+                mesher::uploadChunkMesh(chunkMesh);
+            }
+            if (chunkMesh.mesh.vao != 0) {
+                chunksToRender.push_back(&chunkMesh);
+            }
 
-            // Don't bother to render if the last rendered position is less than (renderDistance / 10) blocks away
-            // unless force render is true
-            if (!forceRender && utility::calculateDistance(getCurrCamera()->pos, lastRenderedPos) <= (float)(renderDistance / 10.0f)) return;
+            // Blocks that aren't baked into the chunk mesh are drawn one by one
+            for (size_t i = 0; i < chunkMesh.specialCells.size(); i++) {
+                auto blockPos = chunkMesh.origin + chunk::localPosition(chunkMesh.specialCells[i]);
+                const auto &data = getBlockProperties(blockPos.x, blockPos.y, blockPos.z);
+                auto &list = data.transparent ? listOfTransBlocksToRender : data.mirror ? listOfShinyBlocksToRender : listOfBlocksToRender;
+                list.push_back(createTerrainNode(blockPos.x, blockPos.y, blockPos.z));
+                list.back().visibleFaces = chunkMesh.specialFaces[i];
+            }
+        }
 
-            listOfBlocksToRender.clear();
-            listOfTransBlocksToRender.clear();
-            listOfShinyBlocksToRender.clear();
+        /**
+         * @brief Checks if the chunk at the given chunk co-ordinates is inside the area last
+         * gathered by updateBlocksToRender
+         * 
+         * @param chunkPos 
+         * @return true 
+         * @return false 
+         */
+        bool isChunkRendered(glm::ivec3 chunkPos) {
+            return chunkPos.x >= minRenderedChunk.x && chunkPos.y >= minRenderedChunk.y && chunkPos.z >= minRenderedChunk.z &&
+                chunkPos.x <= maxRenderedChunk.x && chunkPos.y <= maxRenderedChunk.y && chunkPos.z <= maxRenderedChunk.z;
+        }
 
-            std::vector<glm::vec3> transparentBlocks;
-            int width = worldWidth, height = WORLD_HEIGHT;
-            auto minY = (int)std::max(0, (int)(getCurrCamera()->pos.y - renderDistance));
-            auto maxY = (int)std::min((int)(getCurrCamera()->pos.y + renderDistance), height);
-            auto minX = (int)std::max(0, (int)(getCurrCamera()->pos.x - renderDistance));
-            auto maxX = (int)std::min((int)(getCurrCamera()->pos.x + renderDistance), width);
-            auto minZ = (int)std::max(0, (int)(getCurrCamera()->pos.z - renderDistance));
-            auto maxZ = (int)std::min((int)(getCurrCamera()->pos.z + renderDistance), width);
-            glm::vec2 yRange = glm::vec2(minY, maxY);
-            glm::vec2 xRange = glm::vec2(minX, maxX);
-            glm::vec2 zRange = glm::vec2(minZ, maxZ);
-
-            for (int y = yRange.x; y < yRange.y; y++) {
-                for (int z = zRange.x; z < zRange.y; z++) {
-                    for (int x = xRange.x; x < xRange.y; x++) {
-
-                        if (isCoordOutBoundaries(x, y, z) || terrain.at(x).at(y).at(z).air) {
-                            continue;
-                        }
-                        
-                        if (terrain.at(x).at(y).at(z).transparent) {
-                            terrain.at(x).at(y).at(z).culledFaces = {true, true, true, true, true, true};
+        /**
+         * @brief Takes everything belonging to the given chunk back out of the render lists
+         * 
+         * @param index 
+         */
+        void removeChunkFromRender(size_t index) {
+            auto found = chunkMeshes.find(index);
+            if (found != chunkMeshes.end()) {
+                const auto *chunkMesh = &found->second;
+                chunksToRender.erase(std::remove(chunksToRender.begin(), chunksToRender.end(), chunkMesh), chunksToRender.end());
+            }
+            auto chunkPos = terrain.chunkPosition(index);
+            auto inChunk = [chunkPos](const node_t &node) {
+                return node.x / chunk::CHUNK_SIZE == chunkPos.x && node.y / chunk::CHUNK_SIZE == chunkPos.y && node.z / chunk::CHUNK_SIZE == chunkPos.z;
+            };
+            for (auto list : {&listOfBlocksToRender, &listOfTransBlocksToRender, &listOfShinyBlocksToRender}) {
+                list->erase(std::remove_if(list->begin(), list->end(), inChunk), list->end());
+            }
+        }
 
-                            getHiddenFaces(x, y, z, terrain.at(x).at(y).at(z).culledFaces, false);
+        /**
+         * @brief Remeshes every chunk that has been edited since the last call and refreshes only
+         * their parts of the render lists. Chunks outside of the rendered area stay dirty until
+         * updateBlocksToRender reaches them
+         * 
+         */
+        void updateDirtyChunks() {
+            for (auto index : terrain.dirtyChunks) {
+                auto chunkPos = terrain.chunkPosition(index);
+                auto section = terrain.findChunk(chunkPos.x, chunkPos.y, chunkPos.z);
+                if (!section) continue;
+                section->queued = false;
 
-                            if (utility::countFalses(terrain.at(x).at(y).at(z).culledFaces) < 6) {
-                                listOfTransBlocksToRender.push_back(&terrain.at(x).at(y).at(z));
-                            }
-                            continue;
-                        }
+                if (!section->dirty || !isChunkRendered(chunkPos)) continue;
 
-                        // Figuring out which sides should be rendered or not.
-                        // Only render side if it has air next to it
-                        terrain.at(x).at(y).at(z).culledFaces = {true, true, true, true, true, true};
+                removeChunkFromRender(index);
+                addChunkToRender(index, *section);
+            }
+            terrain.dirtyChunks.clear();
+        }
 
-                        getHiddenFaces(x, y, z, terrain.at(x).at(y).at(z).culledFaces, true);
+        /**
+         * @brief How many chunks out from the player's chunk are kept loaded in an unbounded world
+         * 
+         * @return int 
+         */
+        int pageRadius() const {
+            return (renderDistance + chunk::CHUNK_SIZE - 1) / chunk::CHUNK_SIZE + PAGE_MARGIN;
+        }
 
-                        if (utility::countFalses(terrain.at(x).at(y).at(z).culledFaces) < 6) {
-                            if (strcmp(terrain.at(x).at(y).at(z).name.c_str(), "mirror") == 0) {
-                                listOfShinyBlocksToRender.push_back(&terrain.at(x).at(y).at(z));
-                            } else {
-                                listOfBlocksToRender.push_back(&terrain.at(x).at(y).at(z));
-                            }
-                        }
+        /**
+         * @brief Takes the given chunk out of an unbounded world. Its mesh, lights and reflection
+         * textures are freed here and the pager saves the chunk if the player edited it
+         * 
+         * @param index 
+         */
+        void evictChunk(size_t index) {
+            auto found = terrain.sparseChunks.find(index);
+            if (found == terrain.sparseChunks.end()) return;
+
+            removeChunkFromRender(index);
+            auto chunkMesh = chunkMeshes.find(index);
+            if (chunkMesh != chunkMeshes.end()) {
+                mesher::destroy(chunkMesh->second);
+                chunkMeshes.erase(chunkMesh);
+            }
+            for (auto &instance : found->second.instances) {
+                if (instance.second.lightID >= 0) {
+                    lightRenderer->removeLightSource(instance.second.lightID);
+                }
+                texture_2d::destroy(instance.second.reflectionTexID);
+            }
+            found->second.queued = false;
+            pager.evict(index, std::move(found->second));
+            terrain.sparseChunks.erase(found);
+            auto chunkPos = terrain.chunkPosition(index);
+            terrain.refreshHeightmap(chunkPos.x, chunkPos.y, chunkPos.z);
+        }
 
-                    }
+        /**
+         * @brief Moves the sea and clouds of an unbounded world to be under the given position.
+         * They only move by whole repeats of their textures so the move can't be seen
+         * 
+         * @param pos 
+         */
+        void centreSurfaces(glm::vec3 pos) {
+            seaSurface.translation.x = glm::round(pos.x);
+            seaSurface.translation.z = glm::round(pos.z);
+
+            auto cloudRepeat = (float)cloudSize / (float)CLOUD_TILES;
+            clouds.translation.x = glm::round(pos.x / cloudRepeat) * cloudRepeat;
+            cloudOriginalZ = glm::round(pos.z / cloudRepeat) * cloudRepeat;
+            clouds.translation.z = cloudOriginalZ + cloudOffset;
+        }
+
+        /**
+         * @brief Pages out the chunks of an unbounded world which are too far from the given
+         * position, then asks the pager for the missing chunks around it, nearest first
+         * 
+         * @param pos 
+         */
+        void pageChunks(glm::vec3 pos) {
+            int size = chunk::CHUNK_SIZE;
+            auto centreX = (int)floor(pos.x / (float)size), centreZ = (int)floor(pos.z / (float)size);
+            auto keepRadius = pageRadius() + EVICT_MARGIN;
+
+            std::vector<size_t> evicted;
+            for (const auto &entry : terrain.sparseChunks) {
+                auto chunkPos = terrain.chunkPosition(entry.first);
+                if (abs(chunkPos.x - centreX) > keepRadius || abs(chunkPos.z - centreZ) > keepRadius) {
+                    evicted.push_back(entry.first);
                 }
             }
+            for (auto index : evicted) {
+                evictChunk(index);
+            }
 
-            lastRenderedPos = getCurrCamera()->pos;
+            std::vector<std::pair<int, size_t>> wanted;
+            for (int chunkZ = centreZ - pageRadius(); chunkZ <= centreZ + pageRadius(); chunkZ++) {
+                for (int chunkX = centreX - pageRadius(); chunkX <= centreX + pageRadius(); chunkX++) {
+                    if (chunkX < 0 || chunkZ < 0 || chunkX >= terrain.chunksX || chunkZ >= terrain.chunksZ) continue;
+                    auto distance = (chunkX - centreX) * (chunkX - centreX) + (chunkZ - centreZ) * (chunkZ - centreZ);
+                    for (int chunkY = 0; chunkY < terrain.chunksY; chunkY++) {
+                        auto index = terrain.chunkIndex(chunkX, chunkY, chunkZ);
+                        if (terrain.findChunk(chunkX, chunkY, chunkZ) || pager.isPending(index)) continue;
+                        wanted.emplace_back(distance, index);
+                    }
+                }
+            }
+            std::sort(wanted.begin(), wanted.end());
+            for (const auto &request : wanted) {
+                pager.request(request.second);
+            }
         }
 
         /**
-         * @brief Stores the hidden faces inside the given std::vector
+         * @brief Gives the chunks the pager has finished loading to the terrain. They and their
+         * neighbours, whose border faces may now be hidden, are remeshed by updateDirtyChunks and
+         * their illuminating blocks are given lights
          * 
-         * @param x 
-         * @param y 
-         * @param z 
-         * @param faces 
-         * @param glassIncluded 
          */
-        void getHiddenFaces(int x, int y, int z, std::vector<bool> &faces, bool glassIncluded) {
-            if (!isCoordOutBoundaries(x, y - 1, z) && !(terrain.at(x).at(y - 1).at(z).air || strcmp(terrain.at(x).at(y - 1).at(z).name.c_str(), "mirror") == 0 || glassIncluded * terrain.at(x).at(y - 1).at(z).transparent)) {
-                faces[0] = false; // 0 bottom
+        void receivePagedChunks() {
+            for (auto &loaded : pager.collect()) {
+                auto chunkPos = terrain.chunkPosition(loaded.index);
+                if (terrain.findChunk(chunkPos.x, chunkPos.y, chunkPos.z)) continue;
+
+                auto &section = terrain.sparseChunks.emplace(loaded.index, std::move(loaded.section)).first->second;
+                terrain.refreshHeightmap(chunkPos.x, chunkPos.y, chunkPos.z);
+                terrain.markChunkDirty(section, loaded.index);
+                const glm::ivec3 offsets[] = {{-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}};
+                for (auto offset : offsets) {
+                    auto neighbourPos = chunkPos + offset;
+                    if (auto neighbour = terrain.findChunk(neighbourPos.x, neighbourPos.y, neighbourPos.z)) {
+                        terrain.markChunkDirty(*neighbour, terrain.chunkIndex(neighbourPos.x, neighbourPos.y, neighbourPos.z));
+                    }
+                }
+
+                // Chunks with more than 16 types don't keep a list of them
+                bool lit = section.blocks.bits == 8;
+                for (auto id : section.blocks.types) {
+                    lit = lit || blockRegistry[id].illuminating;
+                }
+                if (lit) {
+                    auto origin = chunkPos * chunk::CHUNK_SIZE;
+                    pendingLights.emplace_back(origin, origin + (chunk::CHUNK_SIZE - 1));
+                }
             }
-            if (!isCoordOutBoundaries(x, y + 1, z) && !(terrain.at(x).at(y + 1).at(z).air || strcmp(terrain.at(x).at(y + 1).at(z).name.c_str(), "mirror") == 0 || glassIncluded * terrain.at(x).at(y + 1).at(z).transparent)) {
-                faces[1] = false; // 1 Is top
+            if (!pendingLights.empty()) {
+                commitEdits(lightRenderer);
             }
-            if (!isCoordOutBoundaries(x, y, z + 1) && !(terrain.at(x).at(y).at(z + 1).air || strcmp(terrain.at(x).at(y).at(z + 1).name.c_str(), "mirror") == 0 || glassIncluded * terrain.at(x).at(y).at(z + 1).transparent)) {
-                faces[2] = false;
+        }
+
+        /**
+         * @brief Call this to update the listOfBlocks to render. Only works if the last rendered position is far away enough from
+         * the player's current position. forceRender = true to ignore this. Edited chunks, and in
+         * unbounded worlds newly paged in chunks, are refreshed either way
+         * 
+         * @param forceRender 
+         */
+        void updateBlocksToRender(bool forceRender = false) {
+            if (unbounded) {
+                receivePagedChunks();
             }
-            if (!isCoordOutBoundaries(x, y, z - 1) && !(terrain.at(x).at(y).at(z - 1).air || strcmp(terrain.at(x).at(y).at(z - 1).name.c_str(), "mirror") == 0 || glassIncluded * terrain.at(x).at(y).at(z - 1).transparent)) {
-                faces[3] = false;
+
+            // Don't bother to render if the last rendered position is less than (renderDistance / 10) blocks away
+            // unless force render is true
+            if (!forceRender && utility::calculateDistance(getCurrCamera()->pos, lastRenderedPos) <= (float)(renderDistance / 10.0f)) {
+                updateDirtyChunks();
+                return;
             }
-            if (!isCoordOutBoundaries(x + 1, y, z) && !(terrain.at(x + 1).at(y).at(z).air || strcmp(terrain.at(x + 1).at(y).at(z).name.c_str(), "mirror") == 0 || glassIncluded * terrain.at(x + 1).at(y).at(z).transparent)) {
-                faces[4] = false;
+
+            if (unbounded) {
+                pageChunks(playerCamera.pos);
+                centreSurfaces(playerCamera.pos);
             }
-            if (!isCoordOutBoundaries(x - 1, y, z) && !(terrain.at(x - 1).at(y).at(z).air || strcmp(terrain.at(x - 1).at(y).at(z).name.c_str(), "mirror") == 0 || glassIncluded * terrain.at(x - 1).at(y).at(z).transparent)) {
-                faces[5] = false;
+
+            listOfBlocksToRender.clear();
+            listOfTransBlocksToRender.clear();
+            listOfShinyBlocksToRender.clear();
+
+            chunksToRender.clear();
+
+            // Finding every chunk that is within the render distance
+            auto pos = getCurrCamera()->pos;
+            int size = chunk::CHUNK_SIZE;
+            auto minChunkY = std::max(0, (int)floor((pos.y - (float)renderDistance) / (float)size));
+            auto maxChunkY = std::min(terrain.chunksY - 1, (int)floor((pos.y + (float)renderDistance) / (float)size));
+            auto minChunkX = std::max(0, (int)floor((pos.x - (float)renderDistance) / (float)size));
+            auto maxChunkX = std::min(terrain.chunksX - 1, (int)floor((pos.x + (float)renderDistance) / (float)size));
+            auto minChunkZ = std::max(0, (int)floor((pos.z - (float)renderDistance) / (float)size));
+            auto maxChunkZ = std::min(terrain.chunksZ - 1, (int)floor((pos.z + (float)renderDistance) / (float)size));
+            minRenderedChunk = glm::ivec3(minChunkX, minChunkY, minChunkZ);
+            maxRenderedChunk = glm::ivec3(maxChunkX, maxChunkY, maxChunkZ);
+
+            auto inRange = (size_t)std::max(0, maxChunkX - minChunkX + 1) * (size_t)std::max(0, maxChunkY - minChunkY + 1) * (size_t)std::max(0, maxChunkZ - minChunkZ + 1);
+            if (terrain.sparse && terrain.totalChunks() < inRange) {
+                // Fewer chunks are stored than are in range, so only the stored ones are looked at
+                terrain.forEachChunk([&](size_t index, chunk::chunk_t &section) {
+                    if (isChunkRendered(terrain.chunkPosition(index))) addChunkToRender(index, section);
+                });
+            } else {
+                for (int chunkY = minChunkY; chunkY <= maxChunkY; chunkY++) {
+                    for (int chunkZ = minChunkZ; chunkZ <= maxChunkZ; chunkZ++) {
+                        for (int chunkX = minChunkX; chunkX <= maxChunkX; chunkX++) {
+                            if (auto section = terrain.findChunk(chunkX, chunkY, chunkZ)) {
+                                addChunkToRender(terrain.chunkIndex(chunkX, chunkY, chunkZ), *section);
+                            }
+                        }
+                    }
+                }
             }
+            // Every dirty chunk in range has just been remeshed
+            updateDirtyChunks();
+
+            lastRenderedPos = getCurrCamera()->pos;
         }
 
         /**
@@ -2248,13 +3057,13 @@ namespace scene {
          * @param parent_mvp 
          * @param renderInfo 
          */
-        void drawScreen(const glm::mat4 &parent_mvp, renderer::renderer_t renderInfo) {
+        void drawScreen(const glm::mat4 &parent_mvp, const renderer::renderer_t &renderInfo) {
             if (hideScreen) return;
             screen.translation = playerCamera.pos;
             screen.rotation.x = playerCamera.pitch;
             screen.rotation.y = -playerCamera.yaw;
 
-            drawElement(&screen, parent_mvp, renderInfo);
+            drawElement<renderer::pass_t::color>(&screen, parent_mvp, renderInfo);
         }
 
         /**
@@ -2262,16 +3071,18 @@ namespace scene {
          * 
          */
         void convertCurrWorldIntoData() {
-            for (size_t x = 0; x < terrain.size(); x++) {
-                for (size_t y = 0; y < terrain.at(0).size(); y++) {
-                    for (size_t z = 0; z < terrain.at(0).at(0).size(); z++) {
-                        if (!terrain.at(x).at(y).at(z).air) {
-                            std::string code = "listOfBlocks.emplace_back(scene::miniBlockData(\"" + terrain.at(x).at(y).at(z).name + "\", glm::vec3(";
-                            std::cout << code.c_str() << x - (float)terrain.size() / 2.0f << ", " << y << ", " << z - (float)terrain.at(0).at(0).size() / 2.0f << "), true));\n";
-                        }
-                    }  
+            // Only stored chunks can hold blocks, which also keeps this quick on unbounded worlds
+            terrain.forEachChunk([this](size_t index, const chunk::chunk_t &section) {
+                if (section.totalSolid == 0) return;
+                auto origin = terrain.chunkPosition(index) * chunk::CHUNK_SIZE;
+                for (int cell = 0; cell < chunk::CHUNK_VOLUME; cell++) {
+                    auto blockPos = origin + chunk::localPosition(cell);
+                    if (!isAir(blockPos.x, blockPos.y, blockPos.z)) {
+                        std::string code = "listOfBlocks.emplace_back(scene::miniBlockData(\"" + getBlockType(blockPos.x, blockPos.y, blockPos.z).blockName + "\", glm::vec3(";
+                        std::cout << code.c_str() << (float)blockPos.x - (float)worldWidth / 2.0f << ", " << blockPos.y << ", " << (float)blockPos.z - (float)worldWidth / 2.0f << "), true));\n";
+                    }
                 }
-            }
+            });
         }
 
         /**
@@ -2279,13 +3090,18 @@ namespace scene {
          * 
          */
         void destroyEverthing() {
-            for (size_t x = 0; x < terrain.size(); x++) {
-                for (size_t y = 0; y < terrain.at(0).size(); y++) {
-                    for (size_t z = 0; z < terrain.at(0).at(0).size(); z++) {
-                        destroy(&terrain.at(x).at(y).at(z), true);
-                    }  
+            pager.stop();
+            terrain.forEachChunk([](size_t, const chunk::chunk_t &section) {
+                for (const auto &instance : section.instances) {
+                    texture_2d::destroy(instance.second.reflectionTexID);
                 }
+            });
+            for (size_t i = 1; i < blockTypes.size(); i++) {
+                texture_2d::destroy(blockTypes[i].texture);
+                texture_2d::destroy(blockTypes[i].specularMap);
+                texture_2d::destroy(blockTypes[i].bloomTexID);
             }
+            destroyBlockTextureArrays();
             destroy(&bed, true);
             destroy(&centreOfWorld, true);
             destroy(&screen, true);
@@ -2312,6 +3128,11 @@ namespace scene {
             }
 
             particle::destroyAllParticles(&listOfParticles);
+            for (auto &entry : chunkMeshes) {
+                mesher::destroy(entry.second);
+            }
+            shapes::destroyCubeCache();
+            instancer::destroy(blockInstances);
         }
     };
 
@@ -15,6 +15,41 @@ namespace shapes {
      */
     static_mesh::mesh_t createCube(bool invertNormals, bool affectedByLight);
 
+    /**
+     * @brief Create the vertex data of a cube without uploading it. Every face has its own 4 vertices
+     * and 6 indices, in the order bottom, top, +z, -z, +x, -x
+     * 
+     * @param invertNormals 
+     * @param affectedByLight 
+     * @return static_mesh::mesh_template_t 
+     */
+    static_mesh::mesh_template_t createCubeTemplate(bool invertNormals, bool affectedByLight);
+
+    /**
+     * @brief Gets the shared cube mesh of the given variant, creating it on first use.
+     * The returned mesh must not be destroyed, use destroyCubeCache instead
+     * 
+     * @param invertNormals 
+     * @param affectedByLight 
+     * @return static_mesh::mesh_t 
+     */
+    static_mesh::mesh_t getCube(bool invertNormals, bool affectedByLight);
+
+    /**
+     * @brief Checks if the given mesh is one of the shared cube meshes from getCube
+     * 
+     * @param mesh 
+     * @return true if the mesh is shared
+     * @return false if the mesh is owned by whoever created it
+     */
+    bool isSharedCube(const static_mesh::mesh_t &mesh);
+
+    /**
+     * @brief Destroys every shared cube mesh made by getCube
+     * 
+     */
+    void destroyCubeCache();
+
     /**
      * @brief Create a static mesh of a one dimensional square
      * 
@@ -41,6 +41,26 @@ namespace static_mesh {
      */
     mesh_t init(mesh_template_t const &mesh_template);
 
+    // Attribute location of the packed vertices made by initPacked
+    const GLuint PACKED_VERTEX_LOCATION = 3;
+
+    /**
+     * Register a buffer of interleaved packed vertices, each read as two unsigned ints at
+     * PACKED_VERTEX_LOCATION. Used by chunk meshes
+     * @param vertices
+     * @param numBytes
+     * @param indices
+     * @return
+     */
+    mesh_t initPacked(const void *vertices, size_t numBytes, std::vector<GLushort> const &indices);
+
+    /**
+     * Number of VAOs, VBOs and EBOs currently alive that were made through init or initPacked,
+     * so chunk meshes are included
+     * @return
+     */
+    size_t totalGLObjects();
+
 }
 
 #endif
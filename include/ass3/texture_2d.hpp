@@ -3,6 +3,7 @@
 
 #include <glad/glad.h>
 #include <string>
+#include <vector>
 
 namespace texture_2d {
 
@@ -22,6 +23,17 @@ namespace texture_2d {
      */
     GLuint init(std::string fileName, params_t const &params = params_t{GL_REPEAT, GL_REPEAT, GL_NEAREST, GL_NEAREST});
 
+    /**
+     * @brief Creates a 2D array texture with one layer per given file, in the same order. Every
+     * file must be the same size as the first. Layers with an empty file name, or whose file is
+     * the wrong size, are left blank
+     * 
+     * @param fileNames 
+     * @param params 
+     * @return GLuint 
+     */
+    GLuint initArray(const std::vector<std::string> &fileNames, params_t const &params = params_t{GL_REPEAT, GL_REPEAT, GL_NEAREST, GL_NEAREST});
+
     GLuint loadCubemap(std::string filePath);
 
     GLuint createEmptyCubeMap(int size);
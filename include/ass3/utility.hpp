@@ -10,6 +10,11 @@
 #include <ass3/static_mesh.hpp>
 #include <ass3/renderer.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 
 namespace utility {
 
@@ -83,15 +88,6 @@ namespace utility {
      */
     void invertShape(static_mesh::mesh_template_t &meshTemplate);
 
-    /**
-     * @brief Count the total falses ionside the given std::vector of bools
-     * and returns it
-     * 
-     * @param vector 
-     * @return int 
-     */
-    int countFalses(std::vector<bool> vector);
-
     /**
      * @brief Calculates the position on a bezier curve given the control points and t value
      * @warning t must be between 0.0f and 1.0f, 1.0f for being at the end of the curve
@@ -110,6 +106,47 @@ namespace utility {
      * @return int 
      */
     int getDirection(float yaw);
+
+    /**
+     * @brief Number of threads to use when the user asks for 0, which is one per core
+     * 
+     * @return unsigned int 
+     */
+    inline unsigned int defaultThreadCount() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * @brief Calls func(i) for every i from 0 to count - 1, shared out between the given number of
+     * threads. The calling thread is one of them, and the call only returns once every i is done.
+     * func must be safe to call from several threads at once
+     * 
+     * @param count 
+     * @param threads 
+     * @param func 
+     */
+    template <typename F>
+    void parallelFor(size_t count, unsigned int threads, F func) {
+        threads = (unsigned int)std::min((size_t)threads, count);
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; i++) func(i);
+            return;
+        }
+
+        // Handing out one index at a time keeps every thread busy even when some are slower
+        std::atomic<size_t> next(0);
+        auto work = [&]() {
+            for (size_t i = next++; i < count; i = next++) func(i);
+        };
+        std::vector<std::thread> workers;
+        for (unsigned int i = 1; i < threads; i++) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
 }
 
 #endif //COMP3421_ass3_UTILITY_HPP
@@ -5,7 +5,20 @@ in vec3 vNormal;
 in vec3 vPosition;
 in vec2 vTexCoord;
 
-uniform vec3 cameraPos;
+struct DirLight {
+    vec3 direction;
+    vec3 color;
+    float ambient;
+};
+
+// Shared by every program, see renderer::frameBlock_t
+layout (std140) uniform FrameData {
+    mat4 uViewProj;
+    mat4 uLightProj;
+    vec3 uCameraPos;
+    DirLight uSun;
+};
+
 uniform sampler2D uTex;
 uniform samplerCube environmentMap;
 
@@ -13,7 +26,7 @@ void main() {
     FragColor = texture(uTex, vTexCoord);
     if (FragColor.r == 0.0f && FragColor.g == 1.0f && FragColor.b == 0.0f) {
         // Only replace color if the color is 100% green
-        vec3 incidence = normalize(vPosition - cameraPos);
+        vec3 incidence = normalize(vPosition - uCameraPos);
         vec3 reflection = reflect(incidence, normalize(vNormal));
         FragColor = vec4(texture(environmentMap, reflection).rgb, 1.0f);
     }
@@ -3,18 +3,72 @@
 layout (location = 0) in vec4 aPos;
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in vec3 aNormal;
+layout (location = 4) in vec3 aInstancePos;
+layout (location = 5) in uint aInstanceData;
 
 out vec3 vNormal;
 out vec3 vPosition;
 out vec2 vTexCoord;
 
-uniform mat4 uViewProjReflection;
+struct DirLight {
+    vec3 direction;
+    vec3 color;
+    float ambient;
+};
+
+// Shared by every program, see renderer::frameBlock_t
+layout (std140) uniform FrameData {
+    mat4 uViewProj;
+    mat4 uLightProj;
+    vec3 uCameraPos;
+    DirLight uSun;
+};
+
 uniform mat4 uModel;
+uniform bool instanced;
+
+// Index of the cube face an axis aligned normal belongs to, same order as the faces in
+// shapes::createCubeTemplate
+uint faceIndex(vec3 normal) {
+    if (normal.y < -0.5) return 0u;
+    if (normal.y > 0.5) return 1u;
+    if (normal.z > 0.5) return 2u;
+    if (normal.z < -0.5) return 3u;
+    return normal.x > 0.5 ? 4u : 5u;
+}
+
+// Rotation of a block instance, see instancer::instance_t. Quarter turns are built from exact
+// sines and cosines so the rotated normals still line up with the axes
+const float QUARTER_COS[4] = float[4](1.0, 0.0, -1.0, 0.0);
+const float QUARTER_SIN[4] = float[4](0.0, 1.0, 0.0, -1.0);
+
+mat3 instanceRotation(uint data) {
+    uint turnsX = (data >> 6) & 3u, turnsY = (data >> 8) & 3u, turnsZ = (data >> 10) & 3u;
+    float cx = QUARTER_COS[turnsX], sx = QUARTER_SIN[turnsX];
+    float cy = QUARTER_COS[turnsY], sy = QUARTER_SIN[turnsY];
+    float cz = QUARTER_COS[turnsZ], sz = QUARTER_SIN[turnsZ];
+    mat3 rotateX = mat3(1, 0, 0, 0, cx, sx, 0, -sx, cx);
+    mat3 rotateY = mat3(cy, 0, -sy, 0, 1, 0, sy, 0, cy);
+    mat3 rotateZ = mat3(cz, sz, 0, -sz, cz, 0, 0, 0, 1);
+    return rotateZ * rotateY * rotateX;
+}
 
 void main() {
+    vec4 pos = aPos;
+    vec3 normal = aNormal;
+    if (instanced) {
+        // Block instance, see instancer::instance_t. Hidden faces are dropped like in default.vert
+        mat3 rotation = instanceRotation(aInstanceData);
+        normal = rotation * aNormal;
+        if ((aInstanceData & (1u << faceIndex(normal))) == 0u) {
+            gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+            return;
+        }
+        pos = vec4(rotation * aPos.xyz + aInstancePos, 1.0);
+    }
 
-    vNormal = normalize(uModel * vec4(aNormal, 0)).xyz;
-    vPosition = (uModel * aPos).xyz;
+    vNormal = normalize(uModel * vec4(normal, 0)).xyz;
+    vPosition = (uModel * pos).xyz;
     vTexCoord = aTexCoord;
-    gl_Position = uViewProjReflection * uModel * aPos;
+    gl_Position = uViewProj * uModel * pos;
 }
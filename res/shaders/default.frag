@@ -22,11 +22,15 @@ in vec2 vTexCoord;
 in vec3 vNormal;
 in vec3 vPosition;
 in vec4 fragPosLightSpace;
+flat in int vIlluminating;
+flat in int vLayer;
 out vec4 fFragColor;
 
 uniform sampler2D uTex;
 uniform sampler2D uSpec;
 uniform sampler2D uDepthMap;
+uniform sampler2DArray uBlockTex;
+uniform sampler2DArray uBlockSpec;
 
 struct Material {
     float texFactor;
@@ -44,6 +48,14 @@ struct DirLight {
     float ambient;
 };
 
+// Shared by every program, see renderer::frameBlock_t
+layout (std140) uniform FrameData {
+    mat4 uViewProj;
+    mat4 uLightProj;
+    vec3 uCameraPos;
+    DirLight uSun;
+};
+
 struct SpotLight {
     vec3 position;
     vec3 diffuse;
@@ -52,13 +64,36 @@ struct SpotLight {
     float intensity;
 };
 
+// Shared by every program, see renderer::lightBlock_t
+layout (std140) uniform LightData {
+    SpotLight allLights[MAX_LIGHTS];
+};
+
 uniform Material uMat;
-uniform DirLight uSun;
-uniform vec3 uCameraPos;
-uniform SpotLight allLights[MAX_LIGHTS];
 uniform bool isIlluminating;
 uniform bool affectedByShadows;
 uniform bool forceBlack;
+uniform bool tiledTexCoords;
+
+// Chunk faces store which segment of the texture strip they use in x (64 apart) and how many
+// blocks they span, so the face texture has to be wrapped back into its segment
+vec2 getTexCoord() {
+    if (!tiledTexCoords) {
+        return vTexCoord;
+    }
+    float segment = floor(vTexCoord.x / 64.0);
+    vec2 local = fract(vec2(vTexCoord.x - segment * 64.0, vTexCoord.y));
+    return vec2((segment + local.x) / 6.0, local.y);
+}
+
+// Blocks read their own layer of the block texture arrays, everything else its own textures
+vec4 diffuseMap(vec2 texCoord) {
+    return vLayer >= 0 ? texture(uBlockTex, vec3(texCoord, float(vLayer))) : texture(uTex, texCoord);
+}
+
+vec4 specularMap(vec2 texCoord) {
+    return vLayer >= 0 ? texture(uBlockSpec, vec3(texCoord, float(vLayer))) : texture(uSpec, texCoord);
+}
 
 vec3 rgbToLinear(vec3 col) {
     return pow(col, vec3(2.2));
@@ -118,15 +153,16 @@ vec3 calcPointLight(SpotLight light, vec3 mat_diffuse, vec3 mat_specular) {
 }
 
 void main() {
+    vec2 texCoord = getTexCoord();
 
     if (vNormal.x == 0 && vNormal.y == 0 && vNormal.z == 0) {
-        fFragColor = texture(uTex, vTexCoord);
-        if (isIlluminating) {
+        fFragColor = diffuseMap(texCoord);
+        if (isIlluminating || vIlluminating != 0) {
             fFragColor *= vec4(1.5, 1.5, 1.5, 1.0);
         }
     } else {
         // Calculating diffuse by lighting
-        vec4 color = mix(uMat.color, texture(uTex, vTexCoord), uMat.texFactor);
+        vec4 color = mix(uMat.color, diffuseMap(texCoord), uMat.texFactor);
         if (forceBlack) color *= vec4(0.0f, 0.0f, 0.0f, 1.0f);
         color.rgb = rgbToLinear(color.rgb);
         
@@ -135,7 +171,7 @@ void main() {
         vec3 diffuse = rgbToLinear(uSun.color) * rgbToLinear(uMat.diffuse) * max(0, lightNormal) * 1.1f;
 
         // Calculating specular
-        vec4 mat_specular = mix(uMat.specular, texture(uSpec, vTexCoord), uMat.specularFactor);
+        vec4 mat_specular = mix(uMat.specular, specularMap(texCoord), uMat.specularFactor);
         vec3 mat_specularV3 = rgbToLinear(mat_specular.rgb);
 
         // Only calculate spot light if there is a diffuse map. This is to avoid lighting on
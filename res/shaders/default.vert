@@ -19,30 +19,112 @@ void main() {
 layout (location = 0) in vec4 aPos;
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in vec3 aNormal;
+layout (location = 3) in uvec2 aPacked;
+layout (location = 4) in vec3 aInstancePos;
+layout (location = 5) in uint aInstanceData;
 
 out vec2 vTexCoord;
 out vec3 vNormal;
 out vec3 vPosition;
 out vec4 fragPosLightSpace;
+flat out int vIlluminating;
+// Layer of the block texture arrays, -1 for anything that isn't a block
+flat out int vLayer;
+
+struct DirLight {
+    vec3 direction;
+    vec3 color;
+    float ambient;
+};
+
+// Shared by every program, see renderer::frameBlock_t
+layout (std140) uniform FrameData {
+    mat4 uViewProj;
+    mat4 uLightProj;
+    vec3 uCameraPos;
+    DirLight uSun;
+};
 
-uniform mat4 uViewProj;
 uniform mat4 uModel;
-uniform mat4 uLightProj;
 uniform vec4 plane;
+uniform bool packedVertex;
+uniform bool instanced;
+
+// Same order as the faces in shapes::createCubeTemplate
+const vec3 FACE_NORMALS[6] = vec3[6](
+    vec3(0, -1, 0), vec3(0, 1, 0), vec3(0, 0, 1), vec3(0, 0, -1), vec3(1, 0, 0), vec3(-1, 0, 0)
+);
+
+// Index of the cube face an axis aligned normal belongs to, same order as FACE_NORMALS
+uint faceIndex(vec3 normal) {
+    if (normal.y < -0.5) return 0u;
+    if (normal.y > 0.5) return 1u;
+    if (normal.z > 0.5) return 2u;
+    if (normal.z < -0.5) return 3u;
+    return normal.x > 0.5 ? 4u : 5u;
+}
+
+// Rotation of a block instance, see instancer::instance_t. Quarter turns are built from exact
+// sines and cosines so the rotated normals still line up with the axes
+const float QUARTER_COS[4] = float[4](1.0, 0.0, -1.0, 0.0);
+const float QUARTER_SIN[4] = float[4](0.0, 1.0, 0.0, -1.0);
+
+mat3 instanceRotation(uint data) {
+    uint turnsX = (data >> 6) & 3u, turnsY = (data >> 8) & 3u, turnsZ = (data >> 10) & 3u;
+    float cx = QUARTER_COS[turnsX], sx = QUARTER_SIN[turnsX];
+    float cy = QUARTER_COS[turnsY], sy = QUARTER_SIN[turnsY];
+    float cz = QUARTER_COS[turnsZ], sz = QUARTER_SIN[turnsZ];
+    mat3 rotateX = mat3(1, 0, 0, 0, cx, sx, 0, -sx, cx);
+    mat3 rotateY = mat3(cy, 0, -sy, 0, 1, 0, sy, 0, cy);
+    mat3 rotateZ = mat3(cz, sz, 0, -sz, cz, 0, 0, 0, 1);
+    return rotateZ * rotateY * rotateX;
+}
 
 void main() {
+    vec4 pos = aPos;
+    vec3 normal = aNormal;
     vTexCoord = aTexCoord;
-    if (aNormal.x == 0 && aNormal.y == 0 && aNormal.z == 0) {
-        vNormal = aNormal;
+    vIlluminating = 0;
+    vLayer = -1;
+    if (instanced) {
+        // Block instance, see instancer::instance_t. Faces hidden by neighbouring blocks are
+        // moved outside the clip volume so their triangles are dropped
+        mat3 rotation = instanceRotation(aInstanceData);
+        normal = rotation * aNormal;
+        if ((aInstanceData & (1u << faceIndex(normal))) == 0u) {
+            gl_ClipDistance[0] = -1.0;
+            gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+            return;
+        }
+        pos = vec4(rotation * aPos.xyz + aInstancePos, 1.0);
+        vLayer = int((aInstanceData >> 12) & 255u);
+        if (((aInstanceData >> 20) & 1u) != 0u) {
+            vIlluminating = 1;
+            normal = vec3(0.0);
+        }
+    }
+    if (packedVertex) {
+        // Chunk mesh vertex, see mesher::packedVertex_t
+        pos = vec4(float(aPacked.x & 31u), float((aPacked.x >> 5) & 31u), float((aPacked.x >> 10) & 31u), 1.0);
+        uint face = (aPacked.x >> 15) & 7u;
+        normal = face < 6u ? FACE_NORMALS[face] : vec3(0.0);
+        vIlluminating = face < 6u ? 0 : 1;
+        vLayer = int((aPacked.y >> 12) & 255u);
+        float segment = float((aPacked.x >> 18) & 7u);
+        vTexCoord = vec2(segment * 64.0 + 32.0 + float(aPacked.y & 63u) - 16.0, float((aPacked.y >> 6) & 63u) - 16.0);
+    }
+
+    if (normal.x == 0 && normal.y == 0 && normal.z == 0) {
+        vNormal = normal;
     } else {
-        vNormal = normalize(uModel * vec4(aNormal, 0)).xyz;
+        vNormal = normalize(uModel * vec4(normal, 0)).xyz;
     }
-    vPosition = (uModel * aPos).xyz;
+    vPosition = (uModel * pos).xyz;
 
-    gl_ClipDistance[0] = dot(uModel * aPos, plane);
+    gl_ClipDistance[0] = dot(uModel * pos, plane);
 
     // Shadow shenanigans
     fragPosLightSpace = uLightProj * vec4(vPosition, 1.0);
 
-    gl_Position = uViewProj * uModel * aPos;
+    gl_Position = uViewProj * uModel * pos;
 }
@@ -8,14 +8,22 @@ out vec4 FragColor;
 
 struct DirLight {
     vec3 direction;
-    vec3 ambient;
+    vec3 color;
+    float ambient;
+};
+
+// Shared by every program, see renderer::frameBlock_t
+layout (std140) uniform FrameData {
+    mat4 uViewProj;
+    mat4 uLightProj;
+    vec3 uCameraPos;
+    DirLight uSun;
 };
 
 uniform sampler2D uTex;
 uniform vec3 uColor;
 uniform bool forceBlack;
 uniform bool affectedByLight;
-uniform DirLight uSun;
 
 
 void main() {
@@ -31,7 +39,7 @@ void main() {
         vec4 baseColor = texture(uTex, vTexCoord);
         if (affectedByLight) {
             float lightNormal = max(0.1f, dot(uSun.direction, vec3(0, 1, 0)));
-            vec4 lightColor = mix(vec4(uSun.ambient, 1.0f), vec4(0.0f, 0.0f, 0.0f, 1.0f), 0.85f);
+            vec4 lightColor = mix(vec4(uSun.color, 1.0f), vec4(0.0f, 0.0f, 0.0f, 1.0f), 0.85f);
             FragColor = mix(baseColor, vec4(lightColor.rgb, baseColor.a), lightNormal * 0.8f);
         } else {
             FragColor = baseColor;
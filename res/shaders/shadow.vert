@@ -1,9 +1,52 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (location = 3) in uvec2 aPacked;
+layout (location = 4) in vec3 aInstancePos;
+layout (location = 5) in uint aInstanceData;
+
+struct DirLight {
+    vec3 direction;
+    vec3 color;
+    float ambient;
+};
+
+// Shared by every program, see renderer::frameBlock_t
+layout (std140) uniform FrameData {
+    mat4 uViewProj;
+    mat4 uLightProj;
+    vec3 uCameraPos;
+    DirLight uSun;
+};
 
-uniform mat4 uLightProj;
 uniform mat4 uModel;
+uniform bool packedVertex;
+uniform bool instanced;
+
+// Rotation of a block instance, see instancer::instance_t. Quarter turns are built from exact
+// sines and cosines so the rotated normals still line up with the axes
+const float QUARTER_COS[4] = float[4](1.0, 0.0, -1.0, 0.0);
+const float QUARTER_SIN[4] = float[4](0.0, 1.0, 0.0, -1.0);
+
+mat3 instanceRotation(uint data) {
+    uint turnsX = (data >> 6) & 3u, turnsY = (data >> 8) & 3u, turnsZ = (data >> 10) & 3u;
+    float cx = QUARTER_COS[turnsX], sx = QUARTER_SIN[turnsX];
+    float cy = QUARTER_COS[turnsY], sy = QUARTER_SIN[turnsY];
+    float cz = QUARTER_COS[turnsZ], sz = QUARTER_SIN[turnsZ];
+    mat3 rotateX = mat3(1, 0, 0, 0, cx, sx, 0, -sx, cx);
+    mat3 rotateY = mat3(cy, 0, -sy, 0, 1, 0, sy, 0, cy);
+    mat3 rotateZ = mat3(cz, sz, 0, -sz, cz, 0, 0, 0, 1);
+    return rotateZ * rotateY * rotateX;
+}
 
 void main() {
-    gl_Position = uLightProj * uModel * vec4(aPos, 1.0);
+    vec3 pos = aPos;
+    if (instanced) {
+        // Block instance, every face casts a shadow so none are skipped
+        pos = instanceRotation(aInstanceData) * aPos + aInstancePos;
+    }
+    if (packedVertex) {
+        // Chunk mesh vertex, only the corner is needed for depth
+        pos = vec3(float(aPacked.x & 31u), float((aPacked.x >> 5) & 31u), float((aPacked.x >> 10) & 31u));
+    }
+    gl_Position = uLightProj * uModel * vec4(pos, 1.0);
 }
\ No newline at end of file
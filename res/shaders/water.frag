@@ -15,9 +15,31 @@ in float rippleEffect;
 
 out vec4 FragColor;
 
+struct DirLight {
+    vec3 direction;
+    vec3 color;
+    float ambient;
+};
+
+// Shared by every program, see renderer::frameBlock_t
+layout (std140) uniform FrameData {
+    mat4 uViewProj;
+    mat4 uLightProj;
+    vec3 uCameraPos;
+    DirLight uSun;
+};
+
 struct SpotLight {
     vec3 position;
+    vec3 diffuse;
+    vec3 ambient;
     vec3 specular;
+    float intensity;
+};
+
+// Shared by every program, see renderer::lightBlock_t
+layout (std140) uniform LightData {
+    SpotLight allLights[MAX_LIGHTS];
 };
 
 uniform float waterLevel;
@@ -25,8 +47,6 @@ uniform vec2 rippleCycle;
 uniform vec2 uPitchFactor;
 uniform vec3 sunColor;
 uniform vec3 sunPos;
-uniform vec3 uCameraPos;
-uniform SpotLight allLights[MAX_LIGHTS];
 
 uniform sampler2D uTex;
 uniform sampler2D uReflection;
@@ -7,7 +7,20 @@ out vec2 vTexCoord;
 out vec4 glPositionSpace;
 out vec3 vPosition;
 
-uniform mat4 uViewProj;
+struct DirLight {
+    vec3 direction;
+    vec3 color;
+    float ambient;
+};
+
+// Shared by every program, see renderer::frameBlock_t
+layout (std140) uniform FrameData {
+    mat4 uViewProj;
+    mat4 uLightProj;
+    vec3 uCameraPos;
+    DirLight uSun;
+};
+
 uniform mat4 uModel;
 
 void main() {
@@ -0,0 +1,70 @@
+#include <ass3/blocks.hpp>
+
+#include <iostream>
+
+namespace blocks {
+
+    const size_t MAX_BLOCK_TYPES = 256;
+
+    /**
+     * @brief Names are only ever looked at here, once per block type, so the rest of
+     * the program can dispatch on the emitter kind instead
+     * 
+     * @param name 
+     * @return emitter_t 
+     */
+    static emitter_t findEmitter(const std::string &name) {
+        if (name == "magma") {
+            return SMOKE_EMITTER;
+        } else if (name == "crying_obsidian") {
+            return TEAR_EMITTER;
+        } else if (name == "redstone_ore") {
+            return DUST_EMITTER;
+        } else if (name == "marccoin_block") {
+            return GLINT_EMITTER;
+        } else if (name.rfind("coral", 0) == 0) {
+            return FISH_EMITTER;
+        }
+        return NO_EMITTER;
+    }
+
+    void registry_t::clear() {
+        properties.clear();
+        names.clear();
+        properties.emplace_back();
+        names.emplace_back("air");
+    }
+
+    uint8_t registry_t::add(const std::string &name, bool transparent, bool illuminating, bool rotatable, glm::vec3 rgb, float intensity) {
+        if (properties.empty()) {
+            clear();
+        }
+        if (properties.size() >= MAX_BLOCK_TYPES) {
+            std::cout << "ERROR: TOO MANY BLOCK TYPES, " << name << " WILL NOT BE PLACEABLE!\n";
+            return 0;
+        }
+
+        properties_t block;
+        block.rgb = rgb;
+        block.intensity = intensity;
+        block.emitter = findEmitter(name);
+        block.transparent = transparent;
+        block.illuminating = illuminating;
+        block.rotatable = rotatable;
+        block.mirror = name == "mirror";
+        block.bouncy = name == "slime_block";
+
+        properties.push_back(block);
+        names.push_back(name);
+        return (uint8_t)(properties.size() - 1);
+    }
+
+    uint8_t registry_t::find(const std::string &name) const {
+        for (size_t i = 1; i < names.size(); i++) {
+            if (names[i] == name) {
+                return (uint8_t)i;
+            }
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,617 @@
+#include <ass3/chunk.hpp>
+
+#include <bitset>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace chunk {
+
+    void palette_t::set(int first, int count, uint8_t id) {
+        int entry = id;
+        if (bits < 8) {
+            entry = (int)(std::find(types.begin(), types.end(), id) - types.begin());
+            if (entry == (int)types.size()) {
+                types.push_back(id);
+            }
+            if (types.size() > (size_t)1 << bits) {
+                // Out of room, so every cell is repacked at the next width up
+                std::array<uint8_t, CHUNK_VOLUME> cells;
+                for (int i = 0; i < CHUNK_VOLUME; i++) cells[(size_t)i] = get(i);
+                bits = bits == 0 ? 1 : bits * 2;
+                words.assign((size_t)(CHUNK_VOLUME * bits / 64), 0);
+                if (bits == 8) {
+                    types.clear();
+                    types.shrink_to_fit();
+                    entry = id;
+                }
+                for (int i = 0; i < CHUNK_VOLUME; i++) {
+                    auto value = bits == 8 ? cells[(size_t)i] : (uint8_t)(std::find(types.begin(), types.end(), cells[(size_t)i]) - types.begin());
+                    auto bit = (size_t)i * (size_t)bits;
+                    words[bit >> 6] |= (uint64_t)value << (bit & 63);
+                }
+            }
+        }
+        if (bits == 0) return;
+
+        auto mask = ((uint64_t)1 << bits) - 1;
+        for (int i = first; i < first + count; i++) {
+            auto bit = (size_t)i * (size_t)bits;
+            auto &word = words[bit >> 6];
+            word = (word & ~(mask << (bit & 63))) | ((uint64_t)entry << (bit & 63));
+        }
+    }
+
+    void palette_t::fill(uint8_t id) {
+        types.assign(1, id);
+        std::vector<uint64_t>().swap(words);
+        bits = 0;
+    }
+
+    void terrain_t::init(int worldWidth, int worldHeight) {
+        width = worldWidth;
+        height = std::min(worldHeight, MAX_HEIGHT);
+        // Rounding up so partially filled chunks at the edge still exist
+        chunksX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        chunksY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        chunksZ = chunksX;
+        sparse = true;
+        paged = false;
+        chunks.clear();
+        chunks.shrink_to_fit();
+        sparseChunks.clear();
+        dirtyChunks.clear();
+        heightmaps.clear();
+    }
+
+    void terrain_t::setSparse(bool makeSparse) {
+        if (makeSparse == sparse) return;
+
+        if (makeSparse) {
+            for (size_t index = 0; index < chunks.size(); index++) {
+                if (chunks[index].totalSolid > 0 || !chunks[index].instances.empty()) {
+                    sparseChunks.emplace(index, std::move(chunks[index]));
+                }
+            }
+            chunks.clear();
+            chunks.shrink_to_fit();
+        } else {
+            chunks.resize((size_t)(chunksX * chunksY * chunksZ));
+            for (auto &entry : sparseChunks) {
+                chunks[entry.first] = std::move(entry.second);
+            }
+            sparseChunks.clear();
+        }
+        sparse = makeSparse;
+    }
+
+    float terrain_t::occupancy() const {
+        size_t occupied = 0;
+        forEachChunk([&occupied](size_t, const chunk_t &section) {
+            if (section.totalSolid > 0) occupied++;
+        });
+        return (float)occupied / (float)(chunksX * chunksY * chunksZ);
+    }
+
+    void terrain_t::setBlock(int x, int y, int z, uint8_t id) {
+        // Clearing a cell of a chunk that was never stored changes nothing, and paged out chunks can't be edited
+        if ((id == AIR || paged) && sparse && !findChunk(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)) return;
+
+        auto &section = chunkAt(x, y, z);
+        auto index = (uint16_t)localIndex(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE);
+        auto cell = section.blocks.get(index);
+
+        if (cell == AIR && id != AIR) {
+            section.totalSolid++;
+        } else if (cell != AIR && id == AIR) {
+            section.totalSolid--;
+        }
+        section.totalOpaque += (blockFlags[id] & OPAQUE_FLAG) - (blockFlags[cell] & OPAQUE_FLAG);
+        section.blocks.set(index, 1, id);
+        section.instances.erase(index);
+        section.edited = true;
+        setColumnCells(x, z, y, y, id != AIR);
+
+        if (!section.rows && id != AIR) {
+            section.rows = std::make_unique<chunkRows_t>();
+        }
+        if (section.rows) {
+            auto row = (size_t)(index / CHUNK_SIZE);
+            auto bit = (uint16_t)(1 << (x % CHUNK_SIZE));
+            auto setBit = [row, bit](std::array<uint16_t, CHUNK_AREA> &rows, bool value) {
+                rows[row] = (uint16_t)(value ? rows[row] | bit : rows[row] & ~bit);
+            };
+            setBit(section.rows->solid, id != AIR);
+            setBit(section.rows->opaque, blockFlags[id] & OPAQUE_FLAG);
+            setBit(section.rows->glass, blockFlags[id] & GLASS_FLAG);
+        }
+
+        // Neighbouring chunks have to be remeshed too if the block sits on the border
+        markChunkDirty(section, chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE));
+        int localX = x % CHUNK_SIZE, localY = y % CHUNK_SIZE, localZ = z % CHUNK_SIZE;
+        if (localX == 0) markDirty(x - 1, y, z);
+        if (localX == CHUNK_SIZE - 1) markDirty(x + 1, y, z);
+        if (localY == 0) markDirty(x, y - 1, z);
+        if (localY == CHUNK_SIZE - 1) markDirty(x, y + 1, z);
+        if (localZ == 0) markDirty(x, y, z - 1);
+        if (localZ == CHUNK_SIZE - 1) markDirty(x, y, z + 1);
+    }
+
+    void terrain_t::rebuildRows(chunk_t &section) const {
+        section.totalSolid = 0;
+        section.totalOpaque = 0;
+        if (section.blocks.bits == 0 && section.blocks.types[0] == AIR) {
+            section.rows.reset();
+            return;
+        }
+        if (!section.rows) {
+            section.rows = std::make_unique<chunkRows_t>();
+        }
+        for (size_t row = 0; row < (size_t)CHUNK_AREA; row++) {
+            uint16_t solid = 0, opaque = 0, glass = 0;
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                auto id = section.blocks.get((int)row * CHUNK_SIZE + x);
+                auto bit = (uint16_t)(1 << x);
+                if (id != AIR) solid |= bit;
+                if (blockFlags[id] & OPAQUE_FLAG) opaque |= bit;
+                if (blockFlags[id] & GLASS_FLAG) glass |= bit;
+            }
+            section.rows->solid[row] = solid;
+            section.rows->opaque[row] = opaque;
+            section.rows->glass[row] = glass;
+            section.totalSolid += (int)std::bitset<CHUNK_SIZE>(solid).count();
+            section.totalOpaque += (int)std::bitset<CHUNK_SIZE>(opaque).count();
+        }
+    }
+
+    void terrain_t::fillChunk(chunk_t &section, glm::ivec3 from, glm::ivec3 to, uint8_t id) const {
+        auto low = glm::max(from, glm::ivec3(0));
+        auto high = glm::min(to, glm::ivec3(CHUNK_SIZE - 1));
+        if (low.x > high.x || low.y > high.y || low.z > high.z) return;
+
+        auto flags = blockFlags[id];
+        bool whole = low == glm::ivec3(0) && high == glm::ivec3(CHUNK_SIZE - 1);
+        if (whole) {
+            // Filling the whole chunk collapses it back down to a single type
+            section.blocks.fill(id);
+        }
+        if (!section.rows && id != AIR) {
+            section.rows = std::make_unique<chunkRows_t>();
+        }
+
+        auto rowMask = (uint16_t)(((1u << (high.x + 1)) - 1) & ~((1u << low.x) - 1));
+        for (int y = low.y; y <= high.y; y++) {
+            for (int z = low.z; z <= high.z; z++) {
+                auto row = (size_t)(y * CHUNK_SIZE + z);
+                if (!whole) {
+                    section.blocks.set((int)row * CHUNK_SIZE + low.x, high.x - low.x + 1, id);
+                }
+                if (!section.rows) continue;
+
+                section.totalSolid -= (int)std::bitset<CHUNK_SIZE>(section.rows->solid[row] & rowMask).count();
+                if (id != AIR) section.totalSolid += high.x - low.x + 1;
+                section.totalOpaque -= (int)std::bitset<CHUNK_SIZE>(section.rows->opaque[row] & rowMask).count();
+                if (flags & OPAQUE_FLAG) section.totalOpaque += high.x - low.x + 1;
+                auto setBits = [row, rowMask](std::array<uint16_t, CHUNK_AREA> &rows, bool value) {
+                    rows[row] = (uint16_t)(value ? rows[row] | rowMask : rows[row] & ~rowMask);
+                };
+                setBits(section.rows->solid, id != AIR);
+                setBits(section.rows->opaque, flags & OPAQUE_FLAG);
+                setBits(section.rows->glass, flags & GLASS_FLAG);
+            }
+        }
+
+        for (auto it = section.instances.begin(); it != section.instances.end();) {
+            auto local = localPosition(it->first);
+            bool inside = local.x >= low.x && local.y >= low.y && local.z >= low.z && local.x <= high.x && local.y <= high.y && local.z <= high.z;
+            it = inside ? section.instances.erase(it) : std::next(it);
+        }
+    }
+
+    void terrain_t::fillBox(glm::ivec3 from, glm::ivec3 to, uint8_t id) {
+        from = glm::max(from, glm::ivec3(0));
+        to = glm::min(to, glm::ivec3(width - 1, height - 1, width - 1));
+        if (from.x > to.x || from.y > to.y || from.z > to.z) return;
+
+        auto fromChunk = from / CHUNK_SIZE, toChunk = to / CHUNK_SIZE;
+        for (int chunkY = fromChunk.y; chunkY <= toChunk.y; chunkY++) {
+            for (int chunkZ = fromChunk.z; chunkZ <= toChunk.z; chunkZ++) {
+                for (int chunkX = fromChunk.x; chunkX <= toChunk.x; chunkX++) {
+                    if ((id == AIR || paged) && sparse && !findChunk(chunkX, chunkY, chunkZ)) continue;
+
+                    auto origin = glm::ivec3(chunkX, chunkY, chunkZ) * CHUNK_SIZE;
+                    auto &section = chunkAt(origin.x, origin.y, origin.z);
+                    fillChunk(section, from - origin, to - origin, id);
+                    section.edited = true;
+
+                    auto low = glm::max(from, origin), high = glm::min(to, origin + (CHUNK_SIZE - 1));
+                    for (int z = low.z; z <= high.z; z++) {
+                        for (int x = low.x; x <= high.x; x++) {
+                            setColumnCells(x, z, low.y, high.y, id != AIR);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Every chunk holding the box or a cell touching it needs a new mesh
+        auto fromNeighbour = glm::max(from - 1, glm::ivec3(0)) / CHUNK_SIZE;
+        auto toNeighbour = glm::min(to + 1, glm::ivec3(width - 1, height - 1, width - 1)) / CHUNK_SIZE;
+        for (int chunkY = fromNeighbour.y; chunkY <= toNeighbour.y; chunkY++) {
+            for (int chunkZ = fromNeighbour.z; chunkZ <= toNeighbour.z; chunkZ++) {
+                for (int chunkX = fromNeighbour.x; chunkX <= toNeighbour.x; chunkX++) {
+                    if (auto section = findChunk(chunkX, chunkY, chunkZ)) {
+                        markChunkDirty(*section, chunkIndex(chunkX, chunkY, chunkZ));
+                    }
+                }
+            }
+        }
+    }
+
+    // Rows of a chunk with a one cell border taken from the neighbouring chunks. Indexed [y + 1][z + 1]
+    // and bit x + 1 holds cell x, so every neighbour of a cell is a shift or a row away
+    const int PADDED_SIZE = CHUNK_SIZE + 2;
+    typedef uint32_t paddedRows_t[PADDED_SIZE][PADDED_SIZE];
+
+    /**
+     * @brief Fills in the padded rows of cells that hide faces, for the chunk at the given chunk
+     * co-ordinates. Cells outside the world hide nothing
+     * 
+     * @param terrain 
+     * @param chunkX 
+     * @param chunkY 
+     * @param chunkZ 
+     * @param hidesAll cells which hide every face
+     * @param hidesGlass cells which hide the faces of glass
+     */
+    static void gatherCovers(const terrain_t &terrain, int chunkX, int chunkY, int chunkZ, paddedRows_t &hidesAll, paddedRows_t &hidesGlass) {
+        for (auto &plane : hidesAll) for (auto &row : plane) row = 0;
+        for (auto &plane : hidesGlass) for (auto &row : plane) row = 0;
+
+        auto copyRows = [&](const chunk_t *section, int fromY, int fromZ, int toY, int toZ, int shift, uint32_t mask) {
+            if (!section || !section->rows) return;
+            auto row = (size_t)(fromY * CHUNK_SIZE + fromZ);
+            auto opaque = (uint32_t)section->rows->opaque[row];
+            auto glass = (uint32_t)section->rows->glass[row];
+            // Shifting the source row so its bits land on the padded x positions
+            auto place = [shift](uint32_t bits) { return shift >= 0 ? bits << shift : bits >> -shift; };
+            hidesAll[toY][toZ] |= place(opaque) & mask;
+            hidesGlass[toY][toZ] |= place(opaque | glass) & mask;
+        };
+
+        const uint32_t INNER = 0xFFFFu << 1;
+        const int last = CHUNK_SIZE - 1;
+        auto centre = terrain.findChunk(chunkX, chunkY, chunkZ);
+        auto below = terrain.findChunk(chunkX, chunkY - 1, chunkZ);
+        auto above = terrain.findChunk(chunkX, chunkY + 1, chunkZ);
+        auto back = terrain.findChunk(chunkX, chunkY, chunkZ - 1);
+        auto front = terrain.findChunk(chunkX, chunkY, chunkZ + 1);
+        auto left = terrain.findChunk(chunkX - 1, chunkY, chunkZ);
+        auto right = terrain.findChunk(chunkX + 1, chunkY, chunkZ);
+
+        for (int a = 0; a < CHUNK_SIZE; a++) {
+            for (int b = 0; b < CHUNK_SIZE; b++) {
+                // a = y, b = z for the chunk itself and its x neighbours
+                copyRows(centre, a, b, a + 1, b + 1, 1, INNER);
+                copyRows(left, a, b, a + 1, b + 1, -last, 1u);
+                copyRows(right, a, b, a + 1, b + 1, last + 2, 1u << (CHUNK_SIZE + 1));
+            }
+            // a = z for the rows above and below, a = y for the rows in front and behind
+            copyRows(below, last, a, 0, a + 1, 1, INNER);
+            copyRows(above, 0, a, CHUNK_SIZE + 1, a + 1, 1, INNER);
+            copyRows(back, a, last, a + 1, 0, 1, INNER);
+            copyRows(front, a, 0, a + 1, CHUNK_SIZE + 1, 1, INNER);
+        }
+    }
+
+    /**
+     * @brief Works out which faces of one layer of rows are not hidden. Bit x + 1 of visible[face][z]
+     * is set if that face of cell x can be seen
+     * 
+     * @param covers 
+     * @param y 
+     * @param visible 
+     */
+    static void cullLayer(const paddedRows_t &covers, int y, uint32_t visible[6][CHUNK_SIZE]) {
+        const auto *row = &covers[y + 1][1];
+        const auto *rowBelow = &covers[y][1];
+        const auto *rowAbove = &covers[y + 2][1];
+        int z = 0;
+#if defined(__AVX2__)
+        for (; z + 8 <= CHUNK_SIZE; z += 8) {
+            auto current = _mm256_loadu_si256((const __m256i *)(row + z));
+            auto all = _mm256_set1_epi32(-1);
+            _mm256_storeu_si256((__m256i *)(visible[0] + z), _mm256_andnot_si256(_mm256_loadu_si256((const __m256i *)(rowBelow + z)), all));
+            _mm256_storeu_si256((__m256i *)(visible[1] + z), _mm256_andnot_si256(_mm256_loadu_si256((const __m256i *)(rowAbove + z)), all));
+            _mm256_storeu_si256((__m256i *)(visible[2] + z), _mm256_andnot_si256(_mm256_loadu_si256((const __m256i *)(row + z + 1)), all));
+            _mm256_storeu_si256((__m256i *)(visible[3] + z), _mm256_andnot_si256(_mm256_loadu_si256((const __m256i *)(row + z - 1)), all));
+            _mm256_storeu_si256((__m256i *)(visible[4] + z), _mm256_andnot_si256(_mm256_srli_epi32(current, 1), all));
+            _mm256_storeu_si256((__m256i *)(visible[5] + z), _mm256_andnot_si256(_mm256_slli_epi32(current, 1), all));
+        }
+#elif defined(__SSE2__)
+        for (; z + 4 <= CHUNK_SIZE; z += 4) {
+            auto current = _mm_loadu_si128((const __m128i *)(row + z));
+            auto all = _mm_set1_epi32(-1);
+            _mm_storeu_si128((__m128i *)(visible[0] + z), _mm_andnot_si128(_mm_loadu_si128((const __m128i *)(rowBelow + z)), all));
+            _mm_storeu_si128((__m128i *)(visible[1] + z), _mm_andnot_si128(_mm_loadu_si128((const __m128i *)(rowAbove + z)), all));
+            _mm_storeu_si128((__m128i *)(visible[2] + z), _mm_andnot_si128(_mm_loadu_si128((const __m128i *)(row + z + 1)), all));
+            _mm_storeu_si128((__m128i *)(visible[3] + z), _mm_andnot_si128(_mm_loadu_si128((const __m128i *)(row + z - 1)), all));
+            _mm_storeu_si128((__m128i *)(visible[4] + z), _mm_andnot_si128(_mm_srli_epi32(current, 1), all));
+            _mm_storeu_si128((__m128i *)(visible[5] + z), _mm_andnot_si128(_mm_slli_epi32(current, 1), all));
+        }
+#endif
+        for (; z < CHUNK_SIZE; z++) {
+            visible[0][z] = ~rowBelow[z];
+            visible[1][z] = ~rowAbove[z];
+            visible[2][z] = ~row[z + 1];
+            visible[3][z] = ~row[z - 1];
+            visible[4][z] = ~(row[z] >> 1);
+            visible[5][z] = ~(row[z] << 1);
+        }
+    }
+
+    /**
+     * @brief Spreads the six visible bits of each cell in a row out into one face mask byte per cell
+     * 
+     * @param visible bit x of visible[face] is set if that face of cell x can be seen
+     * @param masks the CHUNK_SIZE face masks of the row
+     */
+    static void expandRow(const uint16_t visible[6], uint8_t *masks) {
+#if defined(__SSE2__)
+        // Each byte tests the bit belonging to its own cell
+        const auto select = _mm_set_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+        auto result = _mm_setzero_si128();
+        for (int face = 0; face < 6; face++) {
+            auto low = (char)(visible[face] & 0xFF), high = (char)(visible[face] >> 8);
+            auto bits = _mm_set_epi8(high, high, high, high, high, high, high, high, low, low, low, low, low, low, low, low);
+            auto isSet = _mm_cmpeq_epi8(_mm_and_si128(bits, select), select);
+            result = _mm_or_si128(result, _mm_and_si128(isSet, _mm_set1_epi8((char)(1 << face))));
+        }
+        _mm_storeu_si128((__m128i *)masks, result);
+#else
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            uint8_t mask = 0;
+            for (int face = 0; face < 6; face++) {
+                mask |= (uint8_t)(((visible[face] >> x) & 1) << face);
+            }
+            masks[x] = mask;
+        }
+#endif
+    }
+
+    void terrain_t::findFaceMasks(int chunkX, int chunkY, int chunkZ, std::array<uint8_t, CHUNK_VOLUME> &masks) const {
+        auto section = findChunk(chunkX, chunkY, chunkZ);
+        if (!section || section->totalSolid == 0 || !section->rows) {
+            masks.fill(0);
+            return;
+        }
+        const auto &rows = *section->rows;
+
+        paddedRows_t hidesAll, hidesGlass;
+        gatherCovers(*this, chunkX, chunkY, chunkZ, hidesAll, hidesGlass);
+
+        uint32_t visibleSolid[6][CHUNK_SIZE], visibleGlass[6][CHUNK_SIZE];
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            cullLayer(hidesAll, y, visibleSolid);
+            cullLayer(hidesGlass, y, visibleGlass);
+
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                auto row = (size_t)(y * CHUNK_SIZE + z);
+                uint32_t solid = rows.solid[row], glass = rows.glass[row];
+                uint16_t visible[6];
+                for (int face = 0; face < 6; face++) {
+                    // Glass follows its own rule, everything else can see through glass
+                    auto faces = (visibleSolid[face][z] & ~(glass << 1)) | (visibleGlass[face][z] & (glass << 1));
+                    visible[face] = (uint16_t)((faces >> 1) & solid);
+                }
+                expandRow(visible, &masks[row * CHUNK_SIZE]);
+            }
+        }
+    }
+
+    // Finds the highest set bit at or below bit y, -1 if there isn't one
+    static int highestBit(const column_t &column, int y) {
+        for (int word = y / 64; word >= 0; word--) {
+            auto bits = column.solid[(size_t)word];
+            // Only the bits at or below y are wanted from the first word
+            if (word == y / 64 && y % 64 != 63) bits &= ((uint64_t)1 << (y % 64 + 1)) - 1;
+            if (bits) return word * 64 + 63 - __builtin_clzll(bits);
+        }
+        return -1;
+    }
+
+    // Finds the lowest set bit at or above bit y, -1 if there isn't one
+    static int lowestBit(const column_t &column, int y) {
+        for (int word = y / 64; word < MAX_HEIGHT / 64; word++) {
+            auto bits = column.solid[(size_t)word];
+            if (word == y / 64) bits &= ~(((uint64_t)1 << (y % 64)) - 1);
+            if (bits) return word * 64 + __builtin_ctzll(bits);
+        }
+        return -1;
+    }
+
+    int terrain_t::solidBelow(int x, int y, int z) const {
+        auto column = findColumn(x, z);
+        if (!column || y < column->lowest) return -1;
+        if (y >= column->highest) return column->highest;
+        return highestBit(*column, y);
+    }
+
+    int terrain_t::solidAbove(int x, int y, int z) const {
+        auto column = findColumn(x, z);
+        if (!column || y > column->highest) return -1;
+        if (y <= column->lowest) return column->lowest;
+        return lowestBit(*column, y);
+    }
+
+    raycast_t terrain_t::raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance) const {
+        raycast_t result;
+        auto length = glm::length(direction);
+        if (length == 0.0f) return result;
+        direction /= length;
+
+        // Blocks are centred on whole numbers, so shifting by half puts their faces on whole numbers
+        auto start = origin + glm::vec3(0.5f);
+        glm::ivec3 cell((int)floor(start.x), (int)floor(start.y), (int)floor(start.z));
+        // Per axis, which way the ray steps, the distance along the ray to its next face and the
+        // distance between faces
+        glm::ivec3 step(0);
+        glm::vec3 nextFace(INFINITY), faceGap(INFINITY);
+        for (int axis = 0; axis < 3; axis++) {
+            if (direction[axis] > 0.0f) {
+                step[axis] = 1;
+                faceGap[axis] = 1.0f / direction[axis];
+                nextFace[axis] = ((float)cell[axis] + 1.0f - start[axis]) * faceGap[axis];
+            } else if (direction[axis] < 0.0f) {
+                step[axis] = -1;
+                faceGap[axis] = -1.0f / direction[axis];
+                nextFace[axis] = (start[axis] - (float)cell[axis]) * faceGap[axis];
+            }
+        }
+
+        float distance = 0.0f;
+        glm::ivec3 normal(0);
+        while (distance <= maxDistance) {
+            if (isSolid(cell.x, cell.y, cell.z)) {
+                result.hit = true;
+                result.block = cell;
+                result.normal = normal;
+                result.distance = distance;
+                return result;
+            }
+            int axis = nextFace.x < nextFace.y ? (nextFace.x < nextFace.z ? 0 : 2) : (nextFace.y < nextFace.z ? 1 : 2);
+            distance = nextFace[axis];
+            cell[axis] += step[axis];
+            nextFace[axis] += faceGap[axis];
+            normal = glm::ivec3(0);
+            normal[axis] = -step[axis];
+        }
+        return result;
+    }
+
+    void terrain_t::setColumnCells(int x, int z, int fromY, int toY, bool solid) {
+        fromY = std::max(fromY, 0);
+        toY = std::min(toY, MAX_HEIGHT - 1);
+        if (fromY > toY || (unsigned)x >= (unsigned)width || (unsigned)z >= (unsigned)width) return;
+
+        auto key = (size_t)(z / CHUNK_SIZE) * (size_t)chunksX + (size_t)(x / CHUNK_SIZE);
+        auto found = heightmaps.find(key);
+        if (found == heightmaps.end()) {
+            // Clearing cells of a column that has never held a block changes nothing
+            if (!solid) return;
+            found = heightmaps.emplace(key, heightmap_t()).first;
+        }
+        auto &column = found->second.columns[(size_t)((z % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE)];
+
+        for (int word = fromY / 64; word <= toY / 64; word++) {
+            auto low = std::max(fromY, word * 64) % 64, high = std::min(toY, word * 64 + 63) % 64;
+            auto mask = (high == 63 ? ~(uint64_t)0 : ((uint64_t)1 << (high + 1)) - 1) & ~(((uint64_t)1 << low) - 1);
+            auto &bits = column.solid[(size_t)word];
+            bits = solid ? bits | mask : bits & ~mask;
+        }
+
+        if (solid) {
+            column.lowest = (int16_t)(column.lowest < 0 ? fromY : std::min((int)column.lowest, fromY));
+            column.highest = (int16_t)std::max((int)column.highest, toY);
+        } else if (column.highest >= fromY && column.lowest <= toY) {
+            column.lowest = (int16_t)lowestBit(column, 0);
+            column.highest = (int16_t)highestBit(column, MAX_HEIGHT - 1);
+        }
+    }
+
+    void terrain_t::refreshHeightmap(int chunkX, int chunkY, int chunkZ) {
+        if (((unsigned)chunkX >= (unsigned)chunksX) | ((unsigned)chunkY >= (unsigned)chunksY) | ((unsigned)chunkZ >= (unsigned)chunksZ)) return;
+        auto section = findChunk(chunkX, chunkY, chunkZ);
+        bool empty = !section || !section->rows || section->totalSolid == 0;
+
+        auto key = (size_t)chunkZ * (size_t)chunksX + (size_t)chunkX;
+        auto found = heightmaps.find(key);
+        if (found == heightmaps.end()) {
+            if (empty) return;
+            found = heightmaps.emplace(key, heightmap_t()).first;
+        }
+
+        // Every chunk covers 16 bits of a column, which never cross a word
+        auto word = (size_t)(chunkY * CHUNK_SIZE / 64);
+        auto shift = chunkY * CHUNK_SIZE % 64;
+        bool anySolid = false;
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                uint64_t bits = 0;
+                for (int y = 0; y < CHUNK_SIZE && !empty; y++) {
+                    bits |= (uint64_t)((section->rows->solid[(size_t)(y * CHUNK_SIZE + z)] >> x) & 1) << y;
+                }
+                auto &column = found->second.columns[(size_t)(z * CHUNK_SIZE + x)];
+                column.solid[word] = (column.solid[word] & ~((uint64_t)0xFFFF << shift)) | (bits << shift);
+                column.lowest = (int16_t)lowestBit(column, 0);
+                column.highest = (int16_t)highestBit(column, MAX_HEIGHT - 1);
+                anySolid = anySolid || column.highest >= 0;
+            }
+        }
+        // Paged out columns give their heightmap back
+        if (!anySolid) heightmaps.erase(found);
+    }
+
+    bool terrain_t::isHidden(int chunkX, int chunkY, int chunkZ) const {
+        auto section = findChunk(chunkX, chunkY, chunkZ);
+        if (!section || section->totalSolid == 0) return true;
+        if (section->totalOpaque < CHUNK_VOLUME) return false;
+
+        // Checks that every cell of the neighbour touching this chunk is opaque. Faces on the edge
+        // of the world are always seen
+        auto covers = [this](int x, int y, int z, int face) {
+            auto neighbour = findChunk(x, y, z);
+            if (!neighbour || !neighbour->rows) return false;
+            if (neighbour->totalOpaque == CHUNK_VOLUME) return true;
+            const auto &opaque = neighbour->rows->opaque;
+            // The y and z neighbours touch a layer of whole rows, the x neighbours one bit of every row
+            const int last = CHUNK_SIZE - 1;
+            auto mask = (uint16_t)(face == 4 ? 1 : face == 5 ? 1 << last : 0xFFFF);
+            for (int i = 0; i < (face < 4 ? CHUNK_SIZE : CHUNK_AREA); i++) {
+                auto row = (size_t)(face == 0 ? last * CHUNK_SIZE + i : face == 2 ? i * CHUNK_SIZE : face == 3 ? i * CHUNK_SIZE + last : i);
+                if ((opaque[row] & mask) != mask) return false;
+            }
+            return true;
+        };
+        // In the same order as the faces of a cube
+        return covers(chunkX, chunkY - 1, chunkZ, 0) && covers(chunkX, chunkY + 1, chunkZ, 1) &&
+            covers(chunkX, chunkY, chunkZ + 1, 2) && covers(chunkX, chunkY, chunkZ - 1, 3) &&
+            covers(chunkX + 1, chunkY, chunkZ, 4) && covers(chunkX - 1, chunkY, chunkZ, 5);
+    }
+
+    blockInstance_t *terrain_t::findInstance(int x, int y, int z) {
+        auto section = findChunk(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE);
+        if (!section) return nullptr;
+        auto found = section->instances.find((uint16_t)localIndex(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE));
+        if (found == section->instances.end()) {
+            return nullptr;
+        }
+        return &found->second;
+    }
+
+    blockInstance_t &terrain_t::getInstance(int x, int y, int z) {
+        return chunkAt(x, y, z).instances[(uint16_t)localIndex(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE)];
+    }
+
+    void terrain_t::clearInstance(int x, int y, int z) {
+        if (auto section = findChunk(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)) {
+            section->instances.erase((uint16_t)localIndex(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE));
+        }
+    }
+
+    size_t terrain_t::memoryUsage() const {
+        // Sparse chunks also pay for their key and hash node
+        size_t total = chunks.size() * sizeof(chunk_t) + sparseChunks.size() * (sizeof(chunk_t) + sizeof(size_t) + sizeof(void *));
+        forEachChunk([&total](size_t, const chunk_t &section) {
+            total += section.blocks.memoryUsage();
+            total += section.rows ? sizeof(chunkRows_t) : 0;
+            total += section.instances.size() * (sizeof(uint16_t) + sizeof(blockInstance_t));
+        });
+        total += heightmaps.size() * (sizeof(heightmap_t) + sizeof(size_t) + sizeof(void *));
+        return total;
+    }
+}
@@ -0,0 +1,81 @@
+#include <ass3/instancer.hpp>
+#include <ass3/shapes.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace instancer {
+
+    // Bit offsets inside instance_t::data
+    const uint32_t ROTATION_SHIFT = 6;
+    const uint32_t LAYER_SHIFT = 12;
+    const uint32_t ILLUMINATING_SHIFT = 20;
+
+    uint32_t packInstance(glm::vec3 rotation, uint8_t faces, uint8_t layer, bool illuminating) {
+        uint32_t turns = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            // Negative turns wrap around to the matching positive ones
+            auto quarter = (uint32_t)std::lround(rotation[axis] / 90.0f) & 3u;
+            turns |= quarter << (2 * axis);
+        }
+        return ((uint32_t)faces & chunk::ALL_FACES) | turns << ROTATION_SHIFT | (uint32_t)layer << LAYER_SHIFT | (uint32_t)illuminating << ILLUMINATING_SHIFT;
+    }
+
+    void init(instanceBuffer_t &buffer) {
+        // Lit normals are needed to know which face each vertex belongs to, illuminating
+        // instances have theirs cleared in the shader instead
+        buffer.cube = static_mesh::init(shapes::createCubeTemplate(false, true));
+        glGenBuffers(1, &buffer.vbo);
+
+        glBindVertexArray(buffer.cube.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+        glEnableVertexAttribArray(INSTANCE_POSITION_LOCATION);
+        glEnableVertexAttribArray(INSTANCE_DATA_LOCATION);
+        glVertexAttribDivisor(INSTANCE_POSITION_LOCATION, 1);
+        glVertexAttribDivisor(INSTANCE_DATA_LOCATION, 1);
+        bindInstances(buffer, 0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void add(instanceBuffer_t &buffer, glm::vec3 position, glm::vec3 rotation, uint8_t faces, uint8_t blockID, bool illuminating) {
+        instance_t instance;
+        instance.position = position;
+        instance.data = packInstance(rotation, faces, blockID, illuminating);
+        buffer.instances.push_back(instance);
+    }
+
+    void upload(instanceBuffer_t &buffer) {
+        auto &instances = buffer.instances;
+        buffer.uploaded = (GLsizei)instances.size();
+        if (instances.empty()) return;
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+        auto numBytes = instances.size() * sizeof(instance_t);
+        if (numBytes > buffer.capacity) {
+            // Grown in doubles so the buffer settles on a size after a few frames
+            buffer.capacity = std::max(numBytes, buffer.capacity * 2);
+        }
+        // Orphaned every upload, so the driver doesn't wait for the last pass to finish drawing
+        // before letting the instances be overwritten
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)buffer.capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)numBytes, instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void bindInstances(const instanceBuffer_t &buffer, GLint first) {
+        auto offset = (size_t)first * sizeof(instance_t);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+        glVertexAttribPointer(INSTANCE_POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, sizeof(instance_t), (void *)offset);
+        // Integer attribute so the bits reach the shader untouched
+        glVertexAttribIPointer(INSTANCE_DATA_LOCATION, 1, GL_UNSIGNED_INT, sizeof(instance_t), (void *)(offset + sizeof(glm::vec3)));
+    }
+
+    void destroy(instanceBuffer_t &buffer) {
+        if (buffer.cube.vao != 0) {
+            static_mesh::destroy(buffer.cube);
+        }
+        glDeleteBuffers(1, &buffer.vbo);
+        buffer = instanceBuffer_t();
+    }
+}
@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 const int WIN_HEIGHT = 720;
 const int WIN_WIDTH = 1280;
@@ -125,7 +126,7 @@ struct waterTextures {
         normalMap = texture_2d::init("./res/textures/water/normal.png", texture_2d::params_t{GL_REPEAT, GL_REPEAT, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR});
     }
 
-    GLuint getFrame(float dt) {
+    void animate(float dt) {
         frame += dt;
         waterWaveCycle = fmod(waterWaveCycle + (dt / 3.0f), M_PI / 6.0f);
         rippleCycle = fmod(rippleCycle + (dt * waveSpeed), 80.0f);
@@ -134,6 +135,9 @@ struct waterTextures {
             currFrame++;
             currFrame %= 32;
         }
+    }
+
+    GLuint getFrame() {
         return frames[currFrame];
     }
 };
@@ -141,16 +145,18 @@ struct waterTextures {
 int main() {
     srand(time(nullptr));
     // Printing welcome message
-    int worldType = 0, renderDistance = 0, worldWidth = 0, frameLimiter = 1;
+    int worldType = 0, renderDistance = 0, worldWidth = 0, frameLimiter = 1, buildThreads = 0;
     pointerInformation info;
     std::cout << "\n\u001B[34mWelcome to a clone of Minecraft, created by z5309206 for COMP3421 ass3 21T3 UNSW!\n\n\u001B[0m";
     loader::printOutPresets();
     std::cout << "Enter your desired preset world [If not recognised, Basic Super Flat World is used]: ";
     std::cin >> worldType;
     std::cout << "\n";
-    std::cout << "Enter your world's width [Minimum 50 | Maximum 500]: ";
+    std::cout << "Enter your world's width [Minimum 50 | Maximum 500 | 0 for \"Unbounded\"]: ";
     std::cin >> worldWidth;
-    if (worldWidth < 50) {
+    if (worldWidth == 0) {
+        std::cout << "Chunks will be loaded in and out around you as you explore\n";
+    } else if (worldWidth < 50) {
         worldWidth = 50;
     } else if (worldWidth > 500) {
         worldWidth = 500;
@@ -160,6 +166,11 @@ int main() {
     if (renderDistance < 15) {
         renderDistance = 15;
     }
+    std::cout << "Enter how many threads to build the world with [0 for one per core]: ";
+    std::cin >> buildThreads;
+    if (buildThreads < 0) {
+        buildThreads = 0;
+    }
     std::cout << "Enable frame limiter? [0 for \"No\" | Anything else for \"Yes\"]: ";
     std::cin >> frameLimiter;
     std::cout << "Which reflections for Mirror Block? [0 for \"None\" | 1 for \"Premade Cubemap\" | 2 for \"Realtime Cubemap\"] (You can change this ingame with F2): ";
@@ -182,7 +193,8 @@ int main() {
     defaultShader.createProgram("default");
     defaultShader.initialise(WIN_WIDTH, WIN_HEIGHT);
 
-    scene::world gameWorld(listOfBlocks, renderDistance, worldWidth, &defaultShader);
+    std::cout << "Building preset " << worldType << "\n";
+    scene::world gameWorld(listOfBlocks, renderDistance, worldWidth, &defaultShader, (unsigned int)buildThreads);
     if (worldType == 3) {
         // Turns off sea for skyblock
         gameWorld.changeSeaLevel(-1);
@@ -395,8 +407,8 @@ int main() {
         }
     });
 
-    auto xPos = gameWorld.terrain.size() / 2;
-    auto zPos = gameWorld.terrain[0][0].size() / 2;
+    auto xPos = gameWorld.worldWidth / 2;
+    auto zPos = gameWorld.worldWidth / 2;
     gameWorld.playerCamera = player::createCamera(glm::vec3(xPos, 5, zPos), glm::vec3(xPos, -10.0f, zPos));
     gameWorld.cutsceneCamera = player::createCamera(glm::vec3(xPos, 5, zPos), glm::vec3(xPos, -10.0f, zPos));
     gameWorld.reflectionCamera = player::createCamera(glm::vec3(xPos, 5, zPos), glm::vec3(xPos, -10.0f, zPos));
@@ -421,6 +433,7 @@ int main() {
     float degrees = 90;
 
     gameWorld.updateBlocksToRender(true);
+    gameWorld.printChunkMeshUsage();
 
     /**
      * Creating post processing effects
@@ -502,6 +515,8 @@ int main() {
     finalFrameShader.setInt("uTex", 0);
 
     float totalTime = 0.0f;
+    // Time not yet simulated. Starts a whole tick full so the first frame has a tick to blend from
+    float tickTime = scene::TICK_LENGTH;
     float totalFrames = 0.0f;
     float blendValue = 0.0f;
     unsigned int reflectionFrames = 0;
@@ -510,6 +525,7 @@ int main() {
     glfwShowWindow(window);
     glfwFocusWindow(window);
 
+    // Unbounded worlds give the width paged in around the player, which the light view is centred on
     float worldSize = gameWorld.getWorldSize();
     glm::vec3 *playerPosPtr = &gameWorld.playerCamera.pos;
     glm::vec4 clipPlane;
@@ -529,8 +545,6 @@ int main() {
 
         float dt = utility::time_delta();
 
-        gameWorld.spawnBlockParticles();
-
         // Calculating frames per second
         totalTime += dt;
         totalFrames++;
@@ -540,25 +554,40 @@ int main() {
             totalTime = 0;
         }
 
-        // Get input or animate cutscene depending on the cutscene status
-        if (gameWorld.getCutsceneStatus()) {
-            gameWorld.animateCutscene();
-        } else {
-            gameWorld.updatePlayerPositions(window, dt, &defaultShader);
+        // Looking around follows the frame rate so the mouse never feels late. The camera angle
+        // update is reserved for player.cpp as that does not depend on the terrain
+        if (!gameWorld.getCutsceneStatus()) {
+            player::updateCameraAngle(gameWorld.playerCamera, window, scene::TICK_LENGTH);
         }
 
-        // Moving the day cycle around
-        if (gameWorld.cutsceneEnabled) {
-            degrees += 20.0f * dt;
-        } else {
-            degrees += 0.125f * dt;
+        // Simulating the world in fixed ticks, however long the frame took
+        tickTime = std::min(tickTime + dt, scene::MAX_TICKS_PER_FRAME * scene::TICK_LENGTH);
+        while (tickTime >= scene::TICK_LENGTH) {
+            tickTime -= scene::TICK_LENGTH;
+            gameWorld.tick(window, &defaultShader);
+            waterCalculator.animate(scene::TICK_LENGTH);
+
+            // Moving the day cycle around
+            if (gameWorld.cutsceneEnabled) {
+                degrees += 20.0f * scene::TICK_LENGTH;
+            } else {
+                degrees += 0.125f * scene::TICK_LENGTH;
+            }
+            if (degrees >= 360) {
+                gameWorld.updateMoonPhase();
+                degrees -= 360.0f;
+            }
         }
-        if (degrees >= 360) {
-            gameWorld.updateMoonPhase();
-            degrees -= 360.0f;
+        float tickAlpha = tickTime / scene::TICK_LENGTH;
+
+        // The cutscene is timed by the clock rather than ticks, so it follows the frame rate
+        if (gameWorld.getCutsceneStatus()) {
+            gameWorld.animateCutscene();
         }
 
-        gameWorld.updateSunPosition(degrees, dt);
+        // Drawing the player part way through the tick the frame lands in
+        gameWorld.interpolate(tickAlpha);
+        gameWorld.updateSunPosition(degrees);
 
         // Changing and updating where the sun will be
         // sunPosition = glm::vec3(gameWorld.getCurrCamera()->pos.x + (renderDistance) * glm::cos(glm::radians(degrees)), gameWorld.getCurrCamera()->pos.y + (renderDistance - 10) * glm::sin(glm::radians(degrees)), gameWorld.getCurrCamera()->pos.z);
@@ -575,12 +604,13 @@ int main() {
         lightView = glm::lookAt(sunPosition, {playerPosPtr->x, playerPosPtr->y, playerPosPtr->z}, glm::vec3(0.0, 1.0, 0.0));
         lightSpaceMatrix = lightProjection * lightView;
 
-        glUniformMatrix4fv(shadowShader.light_proj_loc, 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
+        // The sun, the light space matrix and any point lights that changed are shared by every program
+        defaultShader.updateBlocks(lightSpaceMatrix);
         glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
         // Drawing the world in the eyes of the shadows
         glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
             glClear(GL_DEPTH_BUFFER_BIT);
-            gameWorld.drawWorld(shadowShader, false, false);
+            gameWorld.drawWorld<renderer::pass_t::shadow>(shadowShader);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
         // Render scene as normal, using the shadow map as the 3rd texture
@@ -591,8 +621,7 @@ int main() {
         defaultShader.activate();
 
         auto view_proj = defaultShader.projection * gameWorld.getCurrCamera()->get_view();
-        glUniformMatrix4fv(defaultShader.view_proj_loc, 1, GL_FALSE, glm::value_ptr(view_proj));
-        glUniformMatrix4fv(defaultShader.light_proj_loc, 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
+        defaultShader.setCamera(view_proj, gameWorld.getCurrCamera()->pos);
 
         reflectionFrames = (reflectionFrames + 1) % REFLECTION_REFRESH_RATE;
         if (info.enableExperimental == 2 && reflectionFrames == 0) {
@@ -641,23 +670,22 @@ int main() {
                     clipPlane = glm::vec4(0, 1, 0, -scene::VOID_LEVEL);
                 }
                 defaultShader.setVec4("plane", clipPlane);
-                defaultShader.setMat4("uViewProj", defaultShader.projection * gameWorld.getCurrCamera()->get_view());
+                defaultShader.setCamera(defaultShader.projection * gameWorld.getCurrCamera()->get_view(), gameWorld.getCurrCamera()->pos);
                 defaultShader.setInt("forceBlack", false);
                 defaultShader.setInt("affectedByShadows", true);
                 glActiveTexture(GL_TEXTURE2);
                 glBindTexture(GL_TEXTURE_2D, depthMapTexID);
-                gameWorld.drawWorld(defaultShader, false, currFBO == untamperedFBO);
+                gameWorld.drawWorld<renderer::pass_t::color>(defaultShader, currFBO == untamperedFBO);
 
                 
                 if (info.enableExperimental > 0 && currFBO == untamperedFBO) {
                     cubeReflectShader.activate();
                     gameWorld.drawShinyTerrain(
-                        view_proj,
                         cubeReflectShader,
                         (info.enableExperimental == 1) ? dayNightCalculator.practice : 0
                     );
                 } else {
-                    gameWorld.drawShinyTerrainNormally(glm::mat4(1.0f), defaultShader, false);
+                    gameWorld.drawShinyTerrainNormally<renderer::pass_t::color>(glm::mat4(1.0f), defaultShader);
                 }
                 defaultShader.activate();
                 
@@ -670,13 +698,6 @@ int main() {
                 // DRAWWATER 
                 if (currFBO == untamperedFBO) {
                     waterShader.activate();
-                    waterShader.setVec3("uCameraPos", gameWorld.getCurrCamera()->pos);
-                    int i = 0;
-                    for (auto light : defaultShader.allLightSources) {
-                        waterShader.setVec3("allLights[" + std::to_string(i) + "].specular", light.specular);
-                        waterShader.setVec3("allLights[" + std::to_string(i) + "].position", light.position);
-                        i++;
-                    }
                     waterShader.setFloat("waterLevel", (GLfloat)gameWorld.seaSurface.translation.y);
                     waterShader.setVec2("rippleCycle", {waterCalculator.rippleCycle * 1000.0f, 1000.0f});
                     waterShader.setVec2("uPitchFactor", {abs(gameWorld.playerCamera.pitch) * 1000.0f, 90000.0f});
@@ -685,11 +706,10 @@ int main() {
                     waterShader.setInt("uRefraction", 11);
                     waterShader.setInt("uDuDvMap", 12);
                     waterShader.setInt("uNormalMap", 13);
-                    waterShader.setMat4("uViewProj", view_proj);
                     waterShader.setMat4("uModel", utility::findModelMatrix(gameWorld.seaSurface.translation, gameWorld.seaSurface.scale, gameWorld.seaSurface.rotation));
                     
                     glActiveTexture(GL_TEXTURE9);
-                    glBindTexture(GL_TEXTURE_2D, waterCalculator.getFrame(dt));
+                    glBindTexture(GL_TEXTURE_2D, waterCalculator.getFrame());
                     glActiveTexture(GL_TEXTURE10);
                     glBindTexture(GL_TEXTURE_2D, waterReflectionTexID);
                     glActiveTexture(GL_TEXTURE11);
@@ -698,13 +718,13 @@ int main() {
                     glBindTexture(GL_TEXTURE_2D, waterCalculator.dudvMap);
                     glActiveTexture(GL_TEXTURE13);
                     glBindTexture(GL_TEXTURE_2D, waterCalculator.normalMap);
-                    scene::drawElement(&gameWorld.seaSurface, glm::mat4(1.0f), waterShader);
+                    scene::drawElement<renderer::pass_t::plain>(&gameWorld.seaSurface, glm::mat4(1.0f), waterShader);
                     glActiveTexture(GL_TEXTURE0);
                 } else if (!gameWorld.cutsceneEnabled && currFBO == waterReflectionFBO) {
                     // Draw the player
                     defaultShader.activate();
                     gameWorld.player.positionInWorld.translation = gameWorld.playerCamera.pos;
-                    scene::drawElement(&gameWorld.player.positionInWorld, glm::mat4(1.0f), defaultShader);
+                    scene::drawElement<renderer::pass_t::color>(&gameWorld.player.positionInWorld, glm::mat4(1.0f), defaultShader);
                 }
                 
 
@@ -716,18 +736,15 @@ int main() {
                 if (!gameWorld.cutsceneEnabled) gameWorld.drawHand(defaultShader);
                 
                 // Drawing cloud
-                scene::drawElement(&gameWorld.clouds, glm::mat4(1.0f), defaultShader);
+                scene::drawElement<renderer::pass_t::color>(&gameWorld.clouds, glm::mat4(1.0f), defaultShader);
 
-                gameWorld.drawTransTerrain(glm::mat4(1.0f), defaultShader, false);
+                gameWorld.drawTransTerrain<renderer::pass_t::color>(glm::mat4(1.0f), defaultShader);
 
                 // Draw particles
                 particleShader.activate();
                 particleShader.setInt("forceBlack", false);
                 particleShader.setVec4("plane", clipPlane);
-                defaultShader.changeSunlight(degrees);
-                particleShader.setVec3("uSun.ambient", defaultShader.sun_light_color);
-                particleShader.setVec3("uSun.direction", defaultShader.sun_light_dir);
-                gameWorld.drawParticles(particleShader, defaultShader.projection, dt);
+                gameWorld.drawParticles(particleShader, defaultShader.projection, tickAlpha);
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
         }
         
@@ -736,16 +753,15 @@ int main() {
         glBindFramebuffer(GL_FRAMEBUFFER, onlyBloomFBO);
             glClearColor(0, 0, 0, 1);
             defaultShader.activate();
-            defaultShader.setMat4("uViewProj", defaultShader.projection * gameWorld.getCurrCamera()->get_view());
+            defaultShader.setCamera(defaultShader.projection * gameWorld.getCurrCamera()->get_view(), gameWorld.getCurrCamera()->pos);
             defaultShader.setInt("forceBlack", true);
-            gameWorld.drawWorld(defaultShader, true, true);
-            gameWorld.drawShinyTerrainNormally(glm::mat4(1.0f), defaultShader, true);
-            scene::drawBlock(&gameWorld.clouds, glm::mat4(1.0f), defaultShader, true);
+            gameWorld.drawWorld<renderer::pass_t::bloom>(defaultShader, true);
+            gameWorld.drawShinyTerrainNormally<renderer::pass_t::bloom>(glm::mat4(1.0f), defaultShader);
+            scene::drawBlock<renderer::pass_t::bloom>(&gameWorld.clouds, glm::mat4(1.0f), defaultShader);
             if (!gameWorld.cutsceneEnabled) gameWorld.drawHand(defaultShader);
             defaultShader.setInt("forceBlack", false);
             // Drawing the water
             waterShader.activate();
-            waterShader.setMat4("uViewProj", view_proj);
             waterShader.setMat4("uModel", utility::findModelMatrix(gameWorld.seaSurface.translation, gameWorld.seaSurface.scale, gameWorld.seaSurface.rotation));
             // Setting up all the textures of the water to be black
             glActiveTexture(GL_TEXTURE9);
@@ -759,14 +775,12 @@ int main() {
             glActiveTexture(GL_TEXTURE13);
             glBindTexture(GL_TEXTURE_2D, waterCalculator.normalMap);
 
-            scene::drawElement(&gameWorld.seaSurface, glm::mat4(1.0f), waterShader);
+            scene::drawElement<renderer::pass_t::plain>(&gameWorld.seaSurface, glm::mat4(1.0f), waterShader);
             // Drawing particles
             particleShader.activate();
             particleShader.setInt("forceBlack", true);
             particleShader.setVec4("plane", clipPlane);
-            particleShader.setVec3("uSun.ambient", defaultShader.sun_light_color);
-            particleShader.setVec3("uSun.direction", defaultShader.sun_light_dir);
-            gameWorld.drawParticles(particleShader, defaultShader.projection, dt, false);
+            gameWorld.drawParticles(particleShader, defaultShader.projection, tickAlpha);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
         // Copy the frame over to the ping pong FBO
@@ -851,6 +865,9 @@ int main() {
         utility::renderQuad();
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+        // Input and the next ticks work on where the player really is
+        gameWorld.finishInterpolation();
+
         glfwSwapBuffers(window);
         glfwPollEvents();
 
@@ -0,0 +1,277 @@
+#include <ass3/mesher.hpp>
+#include <ass3/shapes.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace mesher {
+
+    // Direction each cube face points in, in the same order as shapes::createCubeTemplate
+    const glm::ivec3 FACE_DIRECTIONS[6] = {
+        {0, -1, 0}, {0, 1, 0}, {0, 0, 1}, {0, 0, -1}, {1, 0, 0}, {-1, 0, 0}
+    };
+
+    // For each face, the axis it points along and the two axes it lies across
+    const int NORMAL_AXIS[6] = {1, 1, 2, 2, 0, 0};
+    const int U_AXIS[6] = {0, 0, 0, 0, 2, 2};
+    const int V_AXIS[6] = {2, 2, 1, 1, 1, 1};
+
+    // Faces in the block textures are laid out side by side in one strip
+    const float FACES_IN_TEXTURE = 6.0f;
+    // Normal index given to the faces of illuminating blocks, which are not lit
+    const uint32_t UNLIT_NORMAL = 7;
+    // Tiled texture co-ordinates can go negative, so they are stored with this added
+    const int TEX_COORD_BIAS = 16;
+
+    // Vertex data of the faces of a chunk as they are added
+    struct packedFaces_t {
+        std::vector<packedVertex_t> vertices;
+        std::vector<GLushort> indices;
+    };
+
+    // How the corners and texture co-ordinates of one cube face are arranged
+    struct faceLayout_t {
+        // Which end of the U and V axes each corner sits on
+        glm::ivec2 corners[4];
+        // Texture co-ordinates of the corner at the start of both axes, and how they change
+        // moving one block along each axis. Measured in whole faces of the strip
+        glm::vec2 origin = glm::vec2(0.0f);
+        glm::vec2 alongU = glm::vec2(0.0f);
+        glm::vec2 alongV = glm::vec2(0.0f);
+        uint32_t segment = 0;
+        GLushort indices[6];
+    };
+
+    /**
+     * @brief Works out the layout of every face from shapes::createCubeTemplate so chunk meshes
+     * match blocks drawn on their own. Only made once
+     * 
+     * @return const std::array<faceLayout_t, 6>& 
+     */
+    static const std::array<faceLayout_t, 6> &getFaceLayouts() {
+        static const auto layouts = [] {
+            auto cube = shapes::createCubeTemplate(false, true);
+            float segmentWidth = 1.0f / FACES_IN_TEXTURE;
+            std::array<faceLayout_t, 6> faces;
+
+            for (size_t face = 0; face < 6; face++) {
+                auto &layout = faces[face];
+                float segment = FACES_IN_TEXTURE;
+                for (size_t i = 0; i < 4; i++) {
+                    segment = std::min(segment, std::floor(cube.tex_coords[face * 4 + i].x / segmentWidth + 0.5f));
+                }
+                layout.segment = (uint32_t)segment;
+
+                // Texture co-ordinates of a face are affine in which corner the vertex is on, so the
+                // unit face tells us how to stretch them over a merged quad
+                glm::vec2 local[4];
+                for (size_t i = 0; i < 4; i++) {
+                    const auto &position = cube.positions[face * 4 + i];
+                    layout.corners[i] = glm::ivec2(position[U_AXIS[face]] > 0.0f ? 1 : 0, position[V_AXIS[face]] > 0.0f ? 1 : 0);
+                    local[i] = glm::vec2(cube.tex_coords[face * 4 + i].x / segmentWidth - segment, cube.tex_coords[face * 4 + i].y);
+                }
+                for (size_t i = 0; i < 4; i++) {
+                    if (layout.corners[i] == glm::ivec2(0, 0)) layout.origin = local[i];
+                }
+                for (size_t i = 0; i < 4; i++) {
+                    if (layout.corners[i] == glm::ivec2(1, 0)) layout.alongU = local[i] - layout.origin;
+                    if (layout.corners[i] == glm::ivec2(0, 1)) layout.alongV = local[i] - layout.origin;
+                }
+                for (size_t i = 0; i < 6; i++) {
+                    layout.indices[i] = (GLushort)(cube.indices[face * 6 + i] - face * 4);
+                }
+            }
+            return faces;
+        }();
+        return layouts;
+    }
+
+    packedVertex_t packVertex(glm::ivec3 corner, uint32_t normal, uint32_t segment, glm::ivec2 texCoord, uint8_t layer, uint8_t light) {
+        packedVertex_t vertex;
+        vertex.position = (uint32_t)corner.x | (uint32_t)corner.y << 5 | (uint32_t)corner.z << 10 | normal << 15 | segment << 18;
+        vertex.texture = (uint32_t)(texCoord.x + TEX_COORD_BIAS) | (uint32_t)(texCoord.y + TEX_COORD_BIAS) << 6 | (uint32_t)layer << 12 | (uint32_t)light << 20;
+        return vertex;
+    }
+
+    /**
+     * @brief Appends a quad covering width x height faces to the given vertex data. The texture
+     * repeats once per block
+     * 
+     * @param faces 
+     * @param face 
+     * @param local chunk co-ordinates of the block in the minimum corner of the quad
+     * @param width number of blocks along the U axis of the face
+     * @param height number of blocks along the V axis of the face
+     * @param blockID 
+     * @param lit 
+     */
+    static void addFace(packedFaces_t &faces, size_t face, glm::ivec3 local, int width, int height, uint8_t blockID, bool lit) {
+        const auto &layout = getFaceLayouts()[face];
+        int uAxis = U_AXIS[face], vAxis = V_AXIS[face];
+
+        // Corners of a block start half a block before its centre
+        glm::ivec3 base = local;
+        if (FACE_DIRECTIONS[face][NORMAL_AXIS[face]] > 0) {
+            base[NORMAL_AXIS[face]]++;
+        }
+
+        auto first = (GLushort)faces.vertices.size();
+        for (const auto &corner : layout.corners) {
+            auto position = base;
+            position[uAxis] += corner.x * width;
+            position[vAxis] += corner.y * height;
+            auto texCoord = layout.origin + layout.alongU * (float)(corner.x * width) + layout.alongV * (float)(corner.y * height);
+
+            faces.vertices.push_back(packVertex(position, lit ? (uint32_t)face : UNLIT_NORMAL, layout.segment, glm::ivec2(glm::round(texCoord)), blockID, 255));
+        }
+        for (auto index : layout.indices) {
+            faces.indices.push_back((GLushort)(index + first));
+        }
+    }
+
+    /**
+     * @brief Merges neighbouring visible faces of the same block type, facing the same way, into
+     * as few quads as possible
+     * 
+     * @param faces 
+     * @param blockIDs block type of every cell with a visible face
+     * @param visibleFaces 
+     * @param registry 
+     */
+    static void addMergedFaces(packedFaces_t &faces, const std::array<uint8_t, chunk::CHUNK_VOLUME> &blockIDs, const std::array<uint8_t, chunk::CHUNK_VOLUME> &visibleFaces, const blocks::registry_t &registry) {
+        const int size = chunk::CHUNK_SIZE;
+        std::array<uint8_t, chunk::CHUNK_AREA> mask;
+
+        for (size_t face = 0; face < 6; face++) {
+            int normalAxis = NORMAL_AXIS[face], uAxis = U_AXIS[face], vAxis = V_AXIS[face];
+
+            for (int slice = 0; slice < size; slice++) {
+                // Block type of every visible face in this slice, air if there is no face
+                glm::ivec3 local(0);
+                local[normalAxis] = slice;
+                for (int v = 0; v < size; v++) {
+                    for (int u = 0; u < size; u++) {
+                        local[uAxis] = u;
+                        local[vAxis] = v;
+                        auto index = (size_t)chunk::localIndex(local.x, local.y, local.z);
+                        mask[(size_t)(v * size + u)] = (visibleFaces[index] & (1 << face)) ? blockIDs[index] : chunk::AIR;
+                    }
+                }
+
+                for (int v = 0; v < size; v++) {
+                    for (int u = 0; u < size;) {
+                        auto id = mask[(size_t)(v * size + u)];
+                        if (id == chunk::AIR) {
+                            u++;
+                            continue;
+                        }
+
+                        // Growing the quad along U, then along V for as long as every row matches
+                        int width = 1;
+                        while (u + width < size && mask[(size_t)(v * size + u + width)] == id) width++;
+                        int height = 1;
+                        for (; v + height < size; height++) {
+                            bool rowMatches = true;
+                            for (int i = 0; i < width && rowMatches; i++) {
+                                rowMatches = mask[(size_t)((v + height) * size + u + i)] == id;
+                            }
+                            if (!rowMatches) break;
+                        }
+                        for (int j = 0; j < height; j++) {
+                            for (int i = 0; i < width; i++) {
+                                mask[(size_t)((v + j) * size + u + i)] = chunk::AIR;
+                            }
+                        }
+
+                        local[uAxis] = u;
+                        local[vAxis] = v;
+                        addFace(faces, face, local, width, height, id, !registry[id].illuminating);
+                        u += width;
+                    }
+                }
+            }
+        }
+    }
+
+    void meshChunk(chunkMesh_t &chunkMesh, const chunk::terrain_t &terrain, const blocks::registry_t &registry, int chunkX, int chunkY, int chunkZ, bool greedy) {
+        chunkMesh.needsUpload = true;
+        chunkMesh.vertices.clear();
+        chunkMesh.indices.clear();
+        chunkMesh.surfaceCells.clear();
+        chunkMesh.specialCells.clear();
+        chunkMesh.totalVertices = 0;
+        chunkMesh.origin = glm::ivec3(chunkX, chunkY, chunkZ) * chunk::CHUNK_SIZE;
+        chunkMesh.centre = glm::vec3(chunkMesh.origin) + glm::vec3((float)chunk::CHUNK_SIZE / 2.0f - 0.5f);
+
+        chunkMesh.specialFaces.clear();
+
+        // Chunks of air and chunks buried in opaque blocks have nothing to show
+        auto found = terrain.findChunk(chunkX, chunkY, chunkZ);
+        if (!found || terrain.isHidden(chunkX, chunkY, chunkZ)) return;
+        const auto &section = *found;
+
+        std::array<uint8_t, chunk::CHUNK_VOLUME> masks;
+        terrain.findFaceMasks(chunkX, chunkY, chunkZ, masks);
+
+        // Face masks of the baked blocks only, the rest are drawn on their own. Block types are
+        // unpacked once here for every cell that can be seen
+        std::array<uint8_t, chunk::CHUNK_VOLUME> visibleFaces{};
+        std::array<uint8_t, chunk::CHUNK_VOLUME> blockIDs;
+        for (int index = 0; index < chunk::CHUNK_VOLUME; index++) {
+            auto mask = masks[(size_t)index];
+            if (!mask) continue;
+
+            auto id = section.blocks.get(index);
+            if (!isBaked(registry[id])) {
+                chunkMesh.specialCells.push_back((uint16_t)index);
+                chunkMesh.specialFaces.push_back(mask);
+                continue;
+            }
+            blockIDs[(size_t)index] = id;
+            visibleFaces[(size_t)index] = mask;
+            chunkMesh.surfaceCells.push_back((uint16_t)index);
+        }
+
+        packedFaces_t faces;
+
+        if (greedy) {
+            addMergedFaces(faces, blockIDs, visibleFaces, registry);
+        } else {
+            for (auto cell : chunkMesh.surfaceCells) {
+                auto id = blockIDs[cell];
+                for (size_t face = 0; face < 6; face++) {
+                    if (visibleFaces[cell] & (1 << face)) {
+                        addFace(faces, face, chunk::localPosition(cell), 1, 1, id, !registry[id].illuminating);
+                    }
+                }
+            }
+        }
+
+        chunkMesh.vertices = std::move(faces.vertices);
+        chunkMesh.indices = std::move(faces.indices);
+        chunkMesh.totalVertices = chunkMesh.vertices.size();
+    }
+
+    void uploadChunkMesh(chunkMesh_t &chunkMesh) {
+        destroy(chunkMesh);
+        if (!chunkMesh.indices.empty()) {
+            chunkMesh.mesh = static_mesh::initPacked(chunkMesh.vertices.data(), chunkMesh.vertices.size() * sizeof(packedVertex_t), chunkMesh.indices);
+        }
+        std::vector<packedVertex_t>().swap(chunkMesh.vertices);
+        std::vector<GLushort>().swap(chunkMesh.indices);
+        chunkMesh.needsUpload = false;
+    }
+
+    void buildChunkMesh(chunkMesh_t &chunkMesh, const chunk::terrain_t &terrain, const blocks::registry_t &registry, int chunkX, int chunkY, int chunkZ, bool greedy) {
+        meshChunk(chunkMesh, terrain, registry, chunkX, chunkY, chunkZ, greedy);
+        uploadChunkMesh(chunkMesh);
+    }
+
+    void destroy(chunkMesh_t &chunkMesh) {
+        if (chunkMesh.mesh.vao == 0) return;
+        static_mesh::destroy(chunkMesh.mesh);
+        chunkMesh.mesh = static_mesh::mesh_t();
+    }
+}
@@ -0,0 +1,105 @@
+#include <ass3/pager.hpp>
+
+#include <utility>
+
+namespace pager {
+
+    void pager_t::start(const chunk::terrain_t &pagedTerrain, generator_t chunkGenerator) {
+        stop();
+        terrain = &pagedTerrain;
+        generator = std::move(chunkGenerator);
+        stopping = false;
+        worker = std::thread(&pager_t::run, this);
+    }
+
+    void pager_t::stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            jobs.clear();
+        }
+        wake.notify_all();
+        worker.join();
+        loaded.clear();
+        pending.clear();
+    }
+
+    void pager_t::request(size_t index) {
+        if (!pending.insert(index).second) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job_t job;
+            job.index = index;
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_one();
+    }
+
+    void pager_t::evict(size_t index, chunk::chunk_t section) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job_t job;
+            job.index = index;
+            job.evict = true;
+            job.section = std::move(section);
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_one();
+    }
+
+    std::vector<loaded_t> pager_t::collect() {
+        std::vector<loaded_t> finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.swap(loaded);
+        }
+        for (const auto &done : finished) {
+            pending.erase(done.index);
+        }
+        return finished;
+    }
+
+    void pager_t::run() {
+        while (true) {
+            job_t job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            if (job.evict) {
+                // Unedited chunks can be generated again, so only the edited ones are kept
+                if (!job.section.edited) continue;
+                job.section.rows.reset();
+                for (auto it = job.section.instances.begin(); it != job.section.instances.end();) {
+                    // Lights and reflections are made again on load, only rotations need keeping
+                    it->second.lightID = -1;
+                    it->second.reflectionTexID = 0;
+                    it = it->second.rotation == glm::vec3(0.0f) ? job.section.instances.erase(it) : std::next(it);
+                }
+                saved[job.index] = std::move(job.section);
+                continue;
+            }
+
+            loaded_t done;
+            done.index = job.index;
+            auto found = saved.find(job.index);
+            if (found != saved.end()) {
+                done.section = std::move(found->second);
+                saved.erase(found);
+                terrain->rebuildRows(done.section);
+            } else {
+                generator(done.section, terrain->chunkPosition(job.index));
+            }
+            done.section.dirty = true;
+            done.section.queued = false;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            loaded.push_back(std::move(done));
+        }
+    }
+}
@@ -24,6 +24,7 @@ namespace particle {
 			newParticle->affectedByLight = true;
 			newParticle->lifeTimer = utility::genRandFloat(0.5f, 1.5f);
 			newParticle->translation = position;
+			newParticle->previousTranslation = newParticle->translation;
 			newParticle->minimumYvalue = -999.0f;
 			newParticle->maximumYvalue = 999.0f;
 			newParticle->bounceCount = 0;
@@ -59,6 +60,7 @@ namespace particle {
 			newParticle->affectedByLight = true;
 			newParticle->lifeTimer = utility::genRandFloat(5.0f, 12.0f);
 			newParticle->translation = position;
+			newParticle->previousTranslation = newParticle->translation;
 			newParticle->minimumYvalue = -999.0f;
 			newParticle->maximumYvalue = maxHeight;
 			newParticle->bounceCount = 0;
@@ -91,6 +93,7 @@ namespace particle {
 		newParticle->affectedByLight = true;
 		newParticle->lifeTimer = utility::genRandFloat(20.0f, 30.0f);
 		newParticle->translation = position;
+		newParticle->previousTranslation = newParticle->translation;
 		newParticle->minimumYvalue = -999.0f;
 		newParticle->maximumYvalue = maxHeight;
 		newParticle->bounceCount = 0;
@@ -129,6 +132,7 @@ namespace particle {
 			newParticle->translation.y = position.y;
 			newParticle->translation.z = position.z;
 			newParticle->translation += utility::genRandomPointOnCube(0.505f);
+			newParticle->previousTranslation = newParticle->translation;
 			newParticle->minimumYvalue = minHeight;
 			newParticle->maximumYvalue = newParticle->translation.y;
 			newParticle->bounceCount = 0;
@@ -163,6 +167,7 @@ namespace particle {
 			newParticle->translation.y = position.y;
 			newParticle->translation.z = position.z;
 			newParticle->translation += utility::genRandomPointOnCube(0.515f);
+			newParticle->previousTranslation = newParticle->translation;
 			newParticle->minimumYvalue = -999.0f;
 			newParticle->maximumYvalue = 999.0f;
 			newParticle->bounceCount = 0;
@@ -194,6 +199,7 @@ namespace particle {
 		newParticle->translation.x = position.x + utility::genRandFloat(-3.0f, 3.0f);
 		newParticle->translation.y = position.y + utility::genRandFloat(-3.0f, 3.0f);
 		newParticle->translation.z = position.z + utility::genRandFloat(-3.0f, 3.0f);
+		newParticle->previousTranslation = newParticle->translation;
 
 		newParticle->minimumYvalue = 0;
 		newParticle->maximumYvalue = maxHeight;
@@ -227,6 +233,7 @@ namespace particle {
 			newParticle->translation.x = position.x + utility::genRandFloat(-3.0f, 3.0f);
 			newParticle->translation.y = position.y + utility::genRandFloat( 0.0f, 5.0f);
 			newParticle->translation.z = position.z + utility::genRandFloat(-3.0f, 3.0f);
+			newParticle->previousTranslation = newParticle->translation;
 
 			newParticle->minimumYvalue = minHeight;
 			newParticle->maximumYvalue = 9999;
@@ -262,6 +269,7 @@ namespace particle {
 			newParticle->translation.x = position.x;
 			newParticle->translation.y = position.y;
 			newParticle->translation.z = position.z;
+			newParticle->previousTranslation = newParticle->translation;
 			newParticle->minimumYvalue = position.y;
 			newParticle->maximumYvalue = 999.0f;
 			newParticle->bounceCount = 3;
@@ -282,14 +290,11 @@ namespace particle {
 		return;
 	}
 
-    void drawAllParticles(std::vector<particle_t *> *list, renderer::renderer_t particleRender, glm::mat4 view, glm::mat4 proj, GLfloat gravity, GLfloat dt, bool animate) {
-		size_t index = 0;
-		while (index < list->size()) {
-
-			particle_t* particlePointer = list->at(index);
+    void drawAllParticles(std::vector<particle_t *> *list, const renderer::renderer_t &particleRender, glm::mat4 view, glm::mat4 proj, GLfloat alpha) {
+		for (auto particlePointer : *list) {
 	
 			auto model = glm::mat4(1.0f);
-			model *= glm::translate(glm::mat4(1.0), particlePointer->translation);
+			model *= glm::translate(glm::mat4(1.0), glm::mix(particlePointer->previousTranslation, particlePointer->translation, alpha));
 
 			particleRender.setMat4("uProj", proj);
 			auto viewModel = view * model;
@@ -320,17 +325,23 @@ namespace particle {
 				glDrawElements(GL_TRIANGLES, particlePointer->mesh.indices_count, GL_UNSIGNED_INT, nullptr);
 				glBindVertexArray(0);
 			}
+		}
+	}
 
+	void animateAllParticles(std::vector<particle_t *> *list, GLfloat gravity, GLfloat dt) {
+		size_t index = 0;
+		while (index < list->size()) {
+			particle_t* particlePointer = list->at(index);
 			if (particlePointer->lifeTimer <= 0.0f) {
 				// Destory particle when the timer reaches below 0
 				static_mesh::destroy(list->at(index)->mesh);
 				free(list->at(index));
 				list->erase(list->begin() + (int)index);
 			} else {
-				if (animate) animateParticle(particlePointer, gravity, dt);
+				particlePointer->previousTranslation = particlePointer->translation;
+				animateParticle(particlePointer, gravity, dt);
 				index++;
 			}
-			
 		}
 	}
 
@@ -6,7 +6,8 @@
 
 namespace scene {
 
-    void drawBlock(const node_t *node, glm::mat4 model, renderer::renderer_t renderInfo, bool onlyIlluminating) {
+    template <renderer::pass_t Pass>
+    void drawBlock(const node_t *node, glm::mat4 model, const renderer::renderer_t &renderInfo) {
         
         model *= glm::translate(glm::mat4(1.0), node->translation);
         model *= glm::scale(glm::mat4(1.0), node->scale);
@@ -18,10 +19,10 @@ namespace scene {
 
         if (node->mesh.vbo) {
 
-            if (strcmp(renderInfo.type.c_str(), "default") == 0) {
+            if constexpr (renderer::isTextured(Pass)) {
                 renderInfo.setInt("isIlluminating", node->illuminating);
                 glActiveTexture(GL_TEXTURE0);
-                if (onlyIlluminating) {
+                if (Pass == renderer::pass_t::bloom) {
                     glBindTexture(GL_TEXTURE_2D, node->bloomTexID);
                 } else {
                     glBindTexture(GL_TEXTURE_2D, node->textureID);
@@ -41,12 +42,12 @@ namespace scene {
             glBindVertexArray(node->mesh.vao);
             
             // Ensures to only render the sides that has an air block with that side
-            if (node->ignoreCulling || strcmp(renderInfo.type.c_str(), "shadow") == 0) {
+            if (node->ignoreCulling || Pass == renderer::pass_t::shadow) {
                 glDrawElements(GL_TRIANGLES, node->mesh.indices_count, GL_UNSIGNED_INT, nullptr);
             } else {
-                for (std::vector<int>::size_type index = 0; index < node->culledFaces.size(); index++) {
-                    if (node->culledFaces.at(index)) {
-                        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(index * 6 * (int)sizeof(GLuint)));
+                for (size_t face = 0; face < 6; face++) {
+                    if (node->visibleFaces & (1 << face)) {
+                        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(face * 6 * sizeof(GLuint)));
                     }
                 }
             }
@@ -54,7 +55,8 @@ namespace scene {
         }
     }
 
-    void drawElement(const node_t *node, glm::mat4 model, renderer::renderer_t renderInfo) {
+    template <renderer::pass_t Pass>
+    void drawElement(const node_t *node, glm::mat4 model, const renderer::renderer_t &renderInfo) {
 
         model *= glm::translate(glm::mat4(1.0), node->translation);
         model *= glm::scale(glm::mat4(1.0), node->scale);
@@ -66,7 +68,7 @@ namespace scene {
 
         if (node->mesh.vbo && !node->air) {
 
-            if (strcmp(renderInfo.type.c_str(), "default") == 0) {
+            if constexpr (renderer::isTextured(Pass)) {
                 glActiveTexture(GL_TEXTURE0);
                 glBindTexture(GL_TEXTURE_2D, node->textureID);
                 glActiveTexture(GL_TEXTURE1);
@@ -86,17 +88,96 @@ namespace scene {
         
         // Recursively draw the celestial bodies that are dependent on this celestial body
         for (auto child : node->children) {
-            scene::drawElement(&child, model, renderInfo);
+            scene::drawElement<Pass>(&child, model, renderInfo);
         }
         
         return;
     }
 
+    template <renderer::pass_t Pass>
+    void drawChunk(const mesher::chunkMesh_t *chunkMesh, glm::mat4 model, const renderer::renderer_t &renderInfo) {
+        if (!chunkMesh->mesh.vao) return;
+
+        // Packed corners count from the chunk's corner, half a block before its first block centre
+        model *= glm::translate(glm::mat4(1.0f), glm::vec3(chunkMesh->origin) - glm::vec3(0.5f));
+        glUniformMatrix4fv(renderInfo.model_loc, 1, GL_FALSE, glm::value_ptr(model));
+        renderInfo.setInt("packedVertex", true);
+        glBindVertexArray(chunkMesh->mesh.vao);
+
+        if constexpr (renderer::isTextured(Pass)) {
+            // Every block shares the same material and reads its own layer of the block texture
+            // arrays, so nothing changes between block types
+            glUniform1f(renderInfo.mat_tex_factor_loc, 1.0f);
+            glUniform1f(renderInfo.mat_specular_factor_loc, 1.0f);
+            glUniform4fv(renderInfo.mat_color_loc, 1, glm::value_ptr(glm::vec4(1.0f)));
+            glUniform3fv(renderInfo.mat_diffuse_loc, 1, glm::value_ptr(glm::vec3(1.0f)));
+            glUniform4fv(renderInfo.mat_specular_loc, 1, glm::value_ptr(glm::vec4(1.0f)));
+            glUniform1f(renderInfo.phong_exponent_loc, 5.0f);
+            renderInfo.setInt("isIlluminating", false);
+            renderInfo.setInt("tiledTexCoords", true);
+        }
+
+        glDrawElements(GL_TRIANGLES, chunkMesh->mesh.indices_count, GL_UNSIGNED_SHORT, nullptr);
+
+        if constexpr (renderer::isTextured(Pass)) {
+            renderInfo.setInt("tiledTexCoords", false);
+        }
+        renderInfo.setInt("packedVertex", false);
+        glBindVertexArray(0);
+    }
+
+    template <renderer::pass_t Pass>
+    void drawInstances(const instancer::instanceBuffer_t *instances, glm::mat4 model, const renderer::renderer_t &renderInfo) {
+        if (instances->uploaded == 0) return;
+
+        glUniformMatrix4fv(renderInfo.model_loc, 1, GL_FALSE, glm::value_ptr(model));
+
+        if constexpr (renderer::isTextured(Pass)) {
+            // Same material as the nodes made by world::createTerrainNode. The texture layer and
+            // whether a block glows are carried by each instance
+            glUniform1f(renderInfo.mat_tex_factor_loc, 1.0f);
+            glUniform1f(renderInfo.mat_specular_factor_loc, 1.0f);
+            glUniform4fv(renderInfo.mat_color_loc, 1, glm::value_ptr(glm::vec4(1.0f)));
+            glUniform3fv(renderInfo.mat_diffuse_loc, 1, glm::value_ptr(glm::vec3(1.0f)));
+            glUniform4fv(renderInfo.mat_specular_loc, 1, glm::value_ptr(glm::vec4(1.0f)));
+            glUniform1f(renderInfo.phong_exponent_loc, 5.0f);
+            renderInfo.setInt("isIlluminating", false);
+        }
+
+        renderInfo.setInt("instanced", true);
+        glBindVertexArray(instances->cube.vao);
+        instancer::bindInstances(*instances, 0);
+        glDrawElementsInstanced(GL_TRIANGLES, instances->cube.indices_count, GL_UNSIGNED_INT, nullptr, instances->uploaded);
+        renderInfo.setInt("instanced", false);
+        glBindVertexArray(0);
+    }
+
+    // Every pass the draw functions are built for. drawBlock only draws the clouds' bloom
+    template void drawBlock<renderer::pass_t::bloom>(const node_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawElement<renderer::pass_t::shadow>(const node_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawElement<renderer::pass_t::color>(const node_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawElement<renderer::pass_t::bloom>(const node_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawElement<renderer::pass_t::cubemap>(const node_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawElement<renderer::pass_t::plain>(const node_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawChunk<renderer::pass_t::shadow>(const mesher::chunkMesh_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawChunk<renderer::pass_t::color>(const mesher::chunkMesh_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawChunk<renderer::pass_t::bloom>(const mesher::chunkMesh_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawChunk<renderer::pass_t::cubemap>(const mesher::chunkMesh_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawChunk<renderer::pass_t::plain>(const mesher::chunkMesh_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawInstances<renderer::pass_t::shadow>(const instancer::instanceBuffer_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawInstances<renderer::pass_t::color>(const instancer::instanceBuffer_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawInstances<renderer::pass_t::bloom>(const instancer::instanceBuffer_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawInstances<renderer::pass_t::cubemap>(const instancer::instanceBuffer_t *, glm::mat4, const renderer::renderer_t &);
+    template void drawInstances<renderer::pass_t::plain>(const instancer::instanceBuffer_t *, glm::mat4, const renderer::renderer_t &);
+
     void destroy(const node_t *node, bool destroyTexture) {
         for (auto child : node->children) {
             scene::destroy(&child, destroyTexture);
         }
-        static_mesh::destroy(node->mesh);
+        // Shared cubes are destroyed once through shapes::destroyCubeCache
+        if (!shapes::isSharedCube(node->mesh)) {
+            static_mesh::destroy(node->mesh);
+        }
         if (destroyTexture) {
             texture_2d::destroy(node->textureID);
             texture_2d::destroy(node->specularID);
@@ -108,42 +189,31 @@ namespace scene {
     blockData combineBlockData(std::string stringName, bool transparent, bool illuminating, bool rotatable, glm::vec3 color, float intensity) {
         
         blockData data;
-        GLuint texID, specID, bloomID;
 
         // Checks if the diffuse map exists before initialising it
         std::string diffuseFilePath = "./res/textures/blocks/wool/" + stringName;
         std::ifstream fileStreamA(diffuseFilePath + ".png");
-        if (fileStreamA.good())
-            texID = texture_2d::init(diffuseFilePath + ".png");
-        else {
+        if (!fileStreamA.good()) {
             diffuseFilePath = "./res/textures/blocks/" + stringName;
-            texID = texture_2d::init(diffuseFilePath + ".png");
         }
+        data.textureFile = diffuseFilePath + ".png";
         fileStreamA.close();
         
         // Checks if the specular map exists before initialising it
         std::string specularFilePath = diffuseFilePath + "_specular.png";
         std::ifstream fileStreamB(specularFilePath.c_str());
-        if (fileStreamB.good()) {
-            specID = texture_2d::init(specularFilePath.c_str());
-        } else {
-            specID = texture_2d::init("./res/textures/blocks/default_specular.png");;
-        }
+        data.specularFile = fileStreamB.good() ? specularFilePath : "./res/textures/blocks/default_specular.png";
         fileStreamB.close();
 
         // Checks if the bloom map exists before initialising it
         std::string originalFilePath = diffuseFilePath + "_bloom.png";
         std::ifstream fileStreamC(originalFilePath.c_str());
-        if (fileStreamC.good()) {
-            bloomID = texture_2d::init(originalFilePath.c_str());
-        } else {
-            bloomID = texture_2d::init("./res/textures/blocks/default_bloom.png");;
-        }
+        data.bloomFile = fileStreamC.good() ? originalFilePath : "./res/textures/blocks/default_bloom.png";
         fileStreamC.close();
         
-        data.texture = texID;
-        data.specularMap = specID;
-        data.bloomTexID = bloomID;
+        data.texture = texture_2d::init(data.textureFile);
+        data.specularMap = texture_2d::init(data.specularFile);
+        data.bloomTexID = texture_2d::init(data.bloomFile);
         data.transparent = transparent;
         data.illuminating = illuminating;
         data.intensity = intensity;
@@ -170,7 +240,7 @@ namespace scene {
         node_t block;
         block.name = "N/A";
         block.air = false;
-        block.mesh = shapes::createCube(invertNormals, affectedByLight);
+        block.mesh = shapes::getCube(invertNormals, affectedByLight);
         block.textureID = texID;
         if (specID == 0) {
             specID = texture_2d::init("./res/textures/blocks/default_specular.png");;
@@ -192,7 +262,7 @@ namespace scene {
         node_t block;
         block.name = data.blockName;
         block.air = false;
-        block.mesh = shapes::createCube(invertNormals, affectedByLight);
+        block.mesh = shapes::getCube(invertNormals, affectedByLight);
         block.textureID = data.texture;
         block.specularID = data.specularMap;
         block.x = x;
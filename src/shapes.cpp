@@ -7,6 +7,9 @@ namespace shapes {
     const float lengthOfTexture = 96.0;
     const float lengthOfSide = 16.0;
 
+    // One shared mesh per cube variant, indexed by invertNormals * 2 + affectedByLight
+    static static_mesh::mesh_t cubeCache[4];
+
     const std::vector<GLuint> basicCubicIndices = {
         0, 2, 1, // Face 0 1 2 3
         0, 3, 2,
@@ -28,6 +31,10 @@ namespace shapes {
     };
 
     static_mesh::mesh_t createCube(bool invertNormals, bool affectedByLight) {
+        return static_mesh::init(createCubeTemplate(invertNormals, affectedByLight));
+    }
+
+    static_mesh::mesh_template_t createCubeTemplate(bool invertNormals, bool affectedByLight) {
         static_mesh::mesh_template_t cube;
 
         cube.positions = {
@@ -128,7 +135,7 @@ namespace shapes {
                 cube.normals[i] *= -1;
             }
         }
-        return static_mesh::init(cube);
+        return cube;
     }
 
 
@@ -277,6 +284,31 @@ namespace shapes {
         return static_mesh::init(square);
     }
 
+    static_mesh::mesh_t getCube(bool invertNormals, bool affectedByLight) {
+        auto &cube = cubeCache[(int)invertNormals * 2 + (int)affectedByLight];
+        if (cube.vao == 0) {
+            cube = createCube(invertNormals, affectedByLight);
+        }
+        return cube;
+    }
+
+    bool isSharedCube(const static_mesh::mesh_t &mesh) {
+        if (mesh.vao == 0) return false;
+        for (const auto &cube : cubeCache) {
+            if (cube.vao == mesh.vao) return true;
+        }
+        return false;
+    }
+
+    void destroyCubeCache() {
+        for (auto &cube : cubeCache) {
+            if (cube.vao != 0) {
+                static_mesh::destroy(cube);
+            }
+            cube = static_mesh::mesh_t();
+        }
+    }
+
     static_mesh::mesh_t createFlatSquare(bool invert) {
         static_mesh::mesh_template_t square;
 
@@ -4,8 +4,12 @@
 #include <iostream>
 
 namespace static_mesh {
+    // Every mesh owns exactly one VAO, VBO and EBO
+    static size_t liveMeshes = 0;
+
     mesh_t init(const mesh_template_t &mesh_template) {
         mesh_t mesh;
+        liveMeshes++;
         mesh.indices_count = (GLsizei) mesh_template.indices.size();
 
         glGenVertexArrays(1, &mesh.vao);
@@ -21,6 +25,7 @@ namespace static_mesh {
         
 
         std::vector<float> data;
+        data.reserve(mesh_template.positions.size() * 3 + mesh_template.colors.size() * 3 + mesh_template.tex_coords.size() * 2 + mesh_template.normals.size() * 3);
 
         for (auto i = size_t{0}; i < mesh_template.positions.size(); ++i) {
             data.push_back(mesh_template.positions[i].x);
@@ -98,9 +103,41 @@ namespace static_mesh {
         return mesh;
     }
 
+    mesh_t initPacked(const void *vertices, size_t numBytes, const std::vector<GLushort> &indices) {
+        mesh_t mesh;
+        liveMeshes++;
+        mesh.indices_count = (GLsizei) indices.size();
+
+        glGenVertexArrays(1, &mesh.vao);
+        glGenBuffers(1, &mesh.vbo);
+        glGenBuffers(1, &mesh.ebo);
+
+        glBindVertexArray(mesh.vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) (indices.size() * sizeof(GLushort)), indices.data(), GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) numBytes, vertices, GL_STATIC_DRAW);
+
+        // Integer attribute so the bits reach the shader untouched
+        glEnableVertexAttribArray(PACKED_VERTEX_LOCATION);
+        glVertexAttribIPointer(PACKED_VERTEX_LOCATION, 2, GL_UNSIGNED_INT, 2 * sizeof(GLuint), nullptr);
+
+        glBindVertexArray(0);
+
+        return mesh;
+    }
+
     void destroy(const mesh_t &mesh) {
+        if (mesh.vao != 0 && liveMeshes > 0) {
+            liveMeshes--;
+        }
         glDeleteVertexArrays(1, &mesh.vao);
         glDeleteBuffers(1, &mesh.vbo);
         glDeleteBuffers(1, &mesh.ebo);
     }
+
+    size_t totalGLObjects() {
+        return liveMeshes * 3;
+    }
 }
@@ -1,4 +1,5 @@
 #include <glad/glad.h>
+#include <algorithm>
 #include <iostream>
 #include <stb/stb_image.h>
 #include <chicken3421/chicken3421.hpp>
@@ -46,6 +47,63 @@ namespace texture_2d {
         return tex;
     }
 
+    GLuint initArray(const std::vector<std::string> &fileNames, params_t const &params) {
+        GLuint tex;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, tex);
+
+        GLint maxLayers = 0;
+        glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+        if ((GLint)fileNames.size() > maxLayers) {
+            std::cout << "ERROR: " << fileNames.size() << " layers asked for but array textures can only have " << maxLayers << "\n";
+        }
+        auto layers = std::min((GLint)fileNames.size(), maxLayers);
+
+        int arrayWidth = 0, arrayHeight = 0;
+        for (GLint layer = 0; layer < layers; layer++) {
+            const auto &fileName = fileNames[(size_t)layer];
+            if (fileName.empty()) continue;
+
+            int width, height, n_channels;
+            void *data = stbi_load(fileName.data(), &width, &height, &n_channels, 0);
+            chicken3421::expect(data, "Could not read " + fileName);
+
+            if (arrayWidth == 0) {
+                // Storage is made once the size is known from the first file
+                arrayWidth = width;
+                arrayHeight = height;
+                glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, arrayWidth, arrayHeight, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+            if (width != arrayWidth || height != arrayHeight) {
+                std::cout << "ERROR: " << fileName << " is " << width << "x" << height << " but the other layers are " << arrayWidth << "x" << arrayHeight << "\n";
+            } else {
+                GLenum format = n_channels == 3 ? GL_RGB : GL_RGBA;
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, format, GL_UNSIGNED_BYTE, data);
+            }
+            stbi_image_free(data);
+        }
+
+        switch (params.filter_min) {
+            case GL_LINEAR_MIPMAP_LINEAR:
+            case GL_NEAREST_MIPMAP_LINEAR:
+            case GL_LINEAR_MIPMAP_NEAREST:
+            case GL_NEAREST_MIPMAP_NEAREST:
+                glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+                break;
+            default:
+                break;
+        }
+
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, params.wrap_s);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, params.wrap_t);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, params.filter_min);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, params.filter_max);
+
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        return tex;
+    }
+
     GLuint loadCubemap(std::string filePath) {
 
         std::vector<std::string> faces;
@@ -246,16 +246,6 @@ namespace utility {
 		}
 	}
 
-	int countFalses(std::vector<bool> vector) {
-		int total = 0;
-		for (auto i : vector) {
-			if (!i) {
-				total++;
-			}
-		}
-		return total;
-	}
-
 	glm::vec3 cubicBezier(const std::vector<glm::vec3> &controlPoints, float t) {
 		glm::vec3 pos = (1 - t) * (1 - t) * (1 - t) * controlPoints[0]
 						+ 3 * t * (1 - t) * (1 - t) * controlPoints[1]